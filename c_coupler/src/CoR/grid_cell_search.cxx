@@ -8,8 +8,10 @@
 #include "cor_global_data.h"
 #include "grid_cell_search.h"
 #include "remap_utils_nearest_points.h"
+#include "remap_common_utils.h"
 #include "quick_sort.h"
 #include <math.h>
+#include <vector>
 
 
 void seperate_cells_in_children_tiles(int num_cells, H2D_grid_cell_search_cell **cells, double center_lon, double center_lat, 
@@ -89,6 +91,7 @@ H2D_grid_cell_search_cell::H2D_grid_cell_search_cell(int cell_index, double cent
     this->bounding_circle_center_lat = center_lat;
     this->edge_type = edge_type;
     this->cartesian_coord = NULL;
+    get_3D_cartesian_coord_of_sphere_coord(center_unit_vector[0], center_unit_vector[1], center_unit_vector[2], center_lon, center_lat);
     
     if (num_vertex > 0) {
         EXECUTION_REPORT(REPORT_ERROR, vertex_lons != NULL && vertex_lats != NULL, "Software error2 in H2D_grid_cell_search_cell::H2D_grid_cell_search_cell");
@@ -454,52 +457,6 @@ void H2D_grid_cell_search_tile::divide_tile()
 }
 
 
-bool H2D_grid_cell_search_tile::search_points_within_distance(double dist_threshold, double dst_point_lon, double dst_point_lat, int &num_found_points, long *found_points_indx, double *found_points_dist, bool early_quit)
-{
-    double distance;
-    bool have_the_same_point = false;
-
-
-    distance = calculate_distance_of_two_points_2D(center_lon, center_lat, dst_point_lon, dst_point_lat, true);
-    if (distance - circle_radius > dist_threshold)
-        return have_the_same_point;
-
-    if (cells == NULL) {
-        for (int i = 0; i < TILE_DIVIDE_FACTOR*TILE_DIVIDE_FACTOR; i ++) {
-            if (children[i] == NULL) 
-                break;
-            have_the_same_point |= children[i]->search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, num_found_points, found_points_indx, found_points_dist, early_quit);
-            if (early_quit && have_the_same_point)
-                break;
-        }
-    }
-    else {
-        for (int i = 0; i < num_cells; i ++) {
-            if (!cells[i]->get_mask())
-                continue;
-            if (cells[i]->get_center_lon() == dst_point_lon && cells[i]->get_center_lat() == dst_point_lat) {
-                have_the_same_point = true;
-                distance = 0;
-            }
-            else distance = calculate_distance_of_two_points_2D(cells[i]->get_center_lon(), cells[i]->get_center_lat(), dst_point_lon, dst_point_lat, true);
-            if (distance <= dist_threshold) {
-                found_points_indx[num_found_points] = cells[i]->get_cell_index();
-                found_points_dist[num_found_points] = distance;
-                num_found_points ++;
-            }
-            if (early_quit && have_the_same_point) {
-                found_points_indx[0] = cells[i]->get_cell_index();
-                found_points_dist[0] = 0;
-                num_found_points = 1;
-                break;
-            }
-        }
-    }
-
-    return have_the_same_point;
-}
-
-
 bool H2D_grid_cell_search_tile::has_cell_index(int cell_index)
 {
     if (cells == NULL) {
@@ -520,38 +477,10 @@ bool H2D_grid_cell_search_tile::has_cell_index(int cell_index)
 }
 
 
-void H2D_grid_cell_search_tile::search_overlapping_cells(int &num_overlapping_cells, long *overlapping_cells_index, const H2D_grid_cell_search_cell *dst_cell, bool accurately_match, bool early_quit)
-{
-    double dist = calculate_distance_of_two_points_2D(dst_cell->get_bounding_circle_center_lon(), dst_cell->get_bounding_circle_center_lat(), center_lon, center_lat, true);
-
-    if (dist > dst_cell->get_bounding_circle_radius() + circle_radius)
-        return;
-
-    if (cells == NULL) {
-        for (int i = 0; i < TILE_DIVIDE_FACTOR*TILE_DIVIDE_FACTOR; i ++) {
-            if (children[i] == NULL) 
-                break;
-            children[i]->search_overlapping_cells(num_overlapping_cells, overlapping_cells_index, dst_cell, accurately_match, early_quit);
-            if (early_quit && num_overlapping_cells > 0)
-                return;
-        }
-
-    }
-    else {
-        for (int i = 0; i < num_cells; i ++) {
-            if (dst_cell->check_overlapping(cells[i], accurately_match)) {
-                overlapping_cells_index[num_overlapping_cells++] = cells[i]->get_cell_index();
-                if (early_quit)
-                    return;
-            }
-        }
-    }
-}
-
-
 H2D_grid_cell_search_engine::H2D_grid_cell_search_engine(const Remap_grid_class *remap_grid, const double *center_lons, const double *center_lats, const bool *masks, 
                                                          const bool *redundant_mask, int num_vertex, const double *vertex_lons, const double *vertex_lats, int edge_type, bool build_search_structure)
 {
+    H2D_grid_cell_search_tile *root_tile;
     double center_lon, center_lat, dlon, dlat;
     bool mask = true;
     int i;
@@ -593,9 +522,150 @@ H2D_grid_cell_search_engine::H2D_grid_cell_search_engine(const Remap_grid_class
     EXECUTION_REPORT(REPORT_ERROR, center_lon != NULL_COORD_VALUE && center_lat != NULL_COORD_VALUE && dlon != NULL_COORD_VALUE && dlat != NULL_COORD_VALUE, 
                      "Software error2 in in H2D_grid_cell_search_engine::H2D_grid_cell_search_engine");
     
-    if (build_search_structure)
+    num_tiles = 0;
+    tile_center_unit_vectors = NULL;
+    tile_circle_radius = NULL;
+    tile_cos_circle_radius = NULL;
+    tile_sin_circle_radius = NULL;
+    tile_first_child = NULL;
+    tile_num_children = NULL;
+    tile_first_cell = NULL;
+    tile_num_cells = NULL;
+    tile_stack = NULL;
+    sorted_cell_unit_vectors = NULL;
+    sorted_cell_center_lons = NULL;
+    sorted_cell_center_lats = NULL;
+    sorted_cell_indexes = NULL;
+    sorted_cell_masks = NULL;
+    if (build_search_structure) {
         root_tile = new H2D_grid_cell_search_tile(num_cells, cells_ptr, cells_buffer, index_buffer, NULL, center_lon, center_lat, dlon, dlat);
-    else root_tile = NULL;
+        flatten_search_tiles(root_tile);
+        delete root_tile;
+    }
+}
+
+
+/* The tile tree built recursively is flattened breadth-first into arrays, so that the searches walk contiguous memory 
+    instead of chasing child pointers. The construction of the tiles has already sorted cells_ptr by leaf tiles */
+void H2D_grid_cell_search_engine::flatten_search_tiles(H2D_grid_cell_search_tile *root_tile)
+{
+    std::vector<H2D_grid_cell_search_tile*> tiles;
+    H2D_grid_cell_search_tile *tile;
+    int i, j, first_child;
+
+
+    tiles.push_back(root_tile);
+    for (i = 0; i < tiles.size(); i ++)
+        if (tiles[i]->cells == NULL)
+            for (j = 0; j < TILE_DIVIDE_FACTOR*TILE_DIVIDE_FACTOR && tiles[i]->children[j] != NULL; j ++)
+                tiles.push_back(tiles[i]->children[j]);
+
+    num_tiles = tiles.size();
+    tile_center_unit_vectors = new double [3*num_tiles];
+    tile_circle_radius = new double [num_tiles];
+    tile_cos_circle_radius = new double [num_tiles];
+    tile_sin_circle_radius = new double [num_tiles];
+    tile_first_child = new int [num_tiles];
+    tile_num_children = new int [num_tiles];
+    tile_first_cell = new int [num_tiles];
+    tile_num_cells = new int [num_tiles];
+    tile_stack = new int [num_tiles];
+
+    for (i = 0, first_child = 1; i < num_tiles; i ++) {
+        tile = tiles[i];
+        get_3D_cartesian_coord_of_sphere_coord(tile_center_unit_vectors[3*i], tile_center_unit_vectors[3*i+1], tile_center_unit_vectors[3*i+2], tile->center_lon, tile->center_lat);
+        tile_circle_radius[i] = tile->circle_radius;
+        tile_cos_circle_radius[i] = cos(tile->circle_radius);
+        tile_sin_circle_radius[i] = sin(tile->circle_radius);
+        tile_first_child[i] = first_child;
+        tile_num_children[i] = 0;
+        tile_first_cell[i] = 0;
+        tile_num_cells[i] = 0;
+        if (tile->cells == NULL) {
+            while (tile_num_children[i] < TILE_DIVIDE_FACTOR*TILE_DIVIDE_FACTOR && tile->children[tile_num_children[i]] != NULL)
+                tile_num_children[i] ++;
+            first_child += tile_num_children[i];
+        }
+        else {
+            tile_first_cell[i] = tile->cells - cells_ptr;
+            tile_num_cells[i] = tile->num_cells;
+        }
+    }
+    EXECUTION_REPORT(REPORT_ERROR, -1, first_child == num_tiles, "Software error in H2D_grid_cell_search_engine::flatten_search_tiles");
+
+    sorted_cell_unit_vectors = new double [3*num_cells];
+    sorted_cell_center_lons = new double [num_cells];
+    sorted_cell_center_lats = new double [num_cells];
+    sorted_cell_indexes = new long [num_cells];
+    sorted_cell_masks = new bool [num_cells];
+    for (i = 0; i < num_cells; i ++) {
+        for (j = 0; j < 3; j ++)
+            sorted_cell_unit_vectors[3*i+j] = cells_ptr[i]->get_center_unit_vector()[j];
+        sorted_cell_center_lons[i] = cells_ptr[i]->get_center_lon();
+        sorted_cell_center_lats[i] = cells_ptr[i]->get_center_lat();
+        sorted_cell_indexes[i] = cells_ptr[i]->get_cell_index();
+        sorted_cell_masks[i] = cells_ptr[i]->get_mask();
+    }
+}
+
+
+/* A tile is out of a circle when the great-arc distance between the centers exceeds the sum of the radiuses, which is 
+    checked with the dot product of the unit vectors against the cosine of the sum, without any transcendental function */
+bool H2D_grid_cell_search_engine::is_tile_out_of_circle(int tile_indx, const double *circle_center_unit_vector, double circle_radius, double cos_circle_radius, double sin_circle_radius) const
+{
+    const double *tile_center_unit_vector = tile_center_unit_vectors + 3*tile_indx;
+    double dot_product;
+
+
+    if (tile_circle_radius[tile_indx] + circle_radius >= PI)
+        return false;
+
+    dot_product = tile_center_unit_vector[0]*circle_center_unit_vector[0] + tile_center_unit_vector[1]*circle_center_unit_vector[1] + tile_center_unit_vector[2]*circle_center_unit_vector[2];
+    return dot_product < tile_cos_circle_radius[tile_indx]*cos_circle_radius - tile_sin_circle_radius[tile_indx]*sin_circle_radius;
+}
+
+
+/* The candidate points are ranked with the squared chord distances between unit vectors (monotone with the great-arc 
+    distances), so that found_points_dist holds squared chord distances. The tiles are visited depth-first in the 
+    same order as the children of each tile, with an explicit stack */
+bool H2D_grid_cell_search_engine::search_points_within_distance(double dist_threshold, double dst_point_lon, double dst_point_lat, const double *dst_point_unit_vector,
+                                                                int &num_found_points, long *found_points_indx, double *found_points_dist, bool early_quit)
+{
+    double squared_chord_threshold = convert_arc_distance_to_squared_chord_distance(dist_threshold), cos_threshold = cos(dist_threshold), sin_threshold = sin(dist_threshold), distance;
+    int i, tile_indx, num_tiles_in_stack = 0;
+    bool have_the_same_point = false;
+
+
+    tile_stack[num_tiles_in_stack++] = 0;
+    while (num_tiles_in_stack > 0) {
+        tile_indx = tile_stack[--num_tiles_in_stack];
+        if (is_tile_out_of_circle(tile_indx, dst_point_unit_vector, dist_threshold, cos_threshold, sin_threshold))
+            continue;
+        for (i = tile_num_children[tile_indx]-1; i >= 0; i --)
+            tile_stack[num_tiles_in_stack++] = tile_first_child[tile_indx] + i;
+        for (i = tile_first_cell[tile_indx]; i < tile_first_cell[tile_indx]+tile_num_cells[tile_indx]; i ++) {
+            if (!sorted_cell_masks[i])
+                continue;
+            if (sorted_cell_center_lons[i] == dst_point_lon && sorted_cell_center_lats[i] == dst_point_lat) {
+                have_the_same_point = true;
+                distance = 0;
+            }
+            else distance = compute_squared_chord_distance(sorted_cell_unit_vectors+3*i, dst_point_unit_vector);
+            if (distance <= squared_chord_threshold) {
+                found_points_indx[num_found_points] = sorted_cell_indexes[i];
+                found_points_dist[num_found_points] = distance;
+                num_found_points ++;
+            }
+            if (early_quit && have_the_same_point) {
+                found_points_indx[0] = sorted_cell_indexes[i];
+                found_points_dist[0] = 0;
+                num_found_points = 1;
+                return have_the_same_point;
+            }
+        }
+    }
+
+    return have_the_same_point;
 }
 
 
@@ -608,7 +678,20 @@ H2D_grid_cell_search_engine::~H2D_grid_cell_search_engine()
     delete [] cells_buffer;
     delete [] index_buffer;
     delete [] dist_buffer;
-    delete root_tile;
+    delete [] tile_center_unit_vectors;
+    delete [] tile_circle_radius;
+    delete [] tile_cos_circle_radius;
+    delete [] tile_sin_circle_radius;
+    delete [] tile_first_child;
+    delete [] tile_num_children;
+    delete [] tile_first_cell;
+    delete [] tile_num_cells;
+    delete [] tile_stack;
+    delete [] sorted_cell_unit_vectors;
+    delete [] sorted_cell_center_lons;
+    delete [] sorted_cell_center_lats;
+    delete [] sorted_cell_indexes;
+    delete [] sorted_cell_masks;
 }
 
 
@@ -655,16 +738,19 @@ void H2D_grid_cell_search_engine::recursively_search_initial_boundary(double cen
 void H2D_grid_cell_search_engine::search_nearest_points_var_number(int num_required_points, double dst_point_lon, double dst_point_lat, int &num_found_points, long *found_points_indx, double *found_points_dist, bool early_quit)
 {
     bool have_the_same_point = false;
+    double dst_point_unit_vector[3];
 
 
     if (num_required_points > remap_grid->get_grid_size())
         num_required_points = remap_grid->get_grid_size();
     
     num_found_points = 0;
+    get_3D_cartesian_coord_of_sphere_coord(dst_point_unit_vector[0], dst_point_unit_vector[1], dst_point_unit_vector[2], dst_point_lon, dst_point_lat);
     
     while (num_found_points < num_required_points) {
         num_found_points = 0;
-        have_the_same_point = root_tile->search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, num_found_points, index_buffer, dist_buffer, early_quit);
+        have_the_same_point = search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, dst_point_unit_vector, 
+                                                                       num_found_points, index_buffer, dist_buffer, early_quit);
         if (num_found_points == 0) {
             dist_threshold *= 2;
 			continue;
@@ -687,6 +773,7 @@ void H2D_grid_cell_search_engine::search_nearest_points_var_number(int num_requi
         found_points_indx[i] = index_buffer[i];
         found_points_dist[i] = dist_buffer[i];
     }
+    convert_squared_chord_distances_to_arc_distances(num_required_points, found_points_dist);
     num_found_points = num_required_points;
 }
 
@@ -694,13 +781,16 @@ void H2D_grid_cell_search_engine::search_nearest_points_var_number(int num_requi
 void H2D_grid_cell_search_engine::search_nearest_points_var_distance(double dist_threshold, double dst_point_lon, double dst_point_lat, int &num_found_points, long *found_points_indx, double *found_points_dist, bool early_quit)
 {
     bool have_the_same_point;
+    double dst_point_unit_vector[3];
 
 
-    EXECUTION_REPORT(REPORT_ERROR, root_tile != NULL, "Software error1 in H2D_grid_cell_search_engine::search_nearest_points_var_distance");
+    EXECUTION_REPORT(REPORT_ERROR, num_tiles > 0, "Software error1 in H2D_grid_cell_search_engine::search_nearest_points_var_distance");
     
     this->dist_threshold = dist_threshold;
     num_found_points = 0;
-    have_the_same_point = root_tile->search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, num_found_points, index_buffer, dist_buffer, early_quit);
+    get_3D_cartesian_coord_of_sphere_coord(dst_point_unit_vector[0], dst_point_unit_vector[1], dst_point_unit_vector[2], dst_point_lon, dst_point_lat);
+    have_the_same_point = search_points_within_distance(dist_threshold, dst_point_lon, dst_point_lat, dst_point_unit_vector, 
+                                                                   num_found_points, index_buffer, dist_buffer, early_quit);
 
     do_quick_sort(dist_buffer, index_buffer, 0, num_found_points-1);
     
@@ -715,6 +805,7 @@ void H2D_grid_cell_search_engine::search_nearest_points_var_distance(double dist
         found_points_indx[i] = index_buffer[i];
         found_points_dist[i] = dist_buffer[i];
     }
+    convert_squared_chord_distances_to_arc_distances(num_found_points, found_points_dist);
 }
 
 
@@ -722,10 +813,29 @@ void H2D_grid_cell_search_engine::search_nearest_points_var_distance(double dist
 
 void H2D_grid_cell_search_engine::search_overlapping_cells(int &num_overlapping_cells, long *overlapping_cells_index, const H2D_grid_cell_search_cell *dst_cell, bool accurately_match, bool early_quit) const
 {
-    EXECUTION_REPORT(REPORT_ERROR, -1, root_tile != NULL, "Software error1 in H2D_grid_cell_search_engine::search_overlapping_cells");
+    double dst_circle_unit_vector[3], dst_circle_radius = dst_cell->get_bounding_circle_radius();
+    double cos_dst_circle_radius = cos(dst_circle_radius), sin_dst_circle_radius = sin(dst_circle_radius);
+    int i, tile_indx, num_tiles_in_stack = 0;
+
 
+    EXECUTION_REPORT(REPORT_ERROR, -1, num_tiles > 0, "Software error1 in H2D_grid_cell_search_engine::search_overlapping_cells");
+
+    get_3D_cartesian_coord_of_sphere_coord(dst_circle_unit_vector[0], dst_circle_unit_vector[1], dst_circle_unit_vector[2], dst_cell->get_bounding_circle_center_lon(), dst_cell->get_bounding_circle_center_lat());
     num_overlapping_cells = 0;
-    root_tile->search_overlapping_cells(num_overlapping_cells, index_buffer, dst_cell, accurately_match, early_quit);
+    tile_stack[num_tiles_in_stack++] = 0;
+    while (num_tiles_in_stack > 0 && !(early_quit && num_overlapping_cells > 0)) {
+        tile_indx = tile_stack[--num_tiles_in_stack];
+        if (is_tile_out_of_circle(tile_indx, dst_circle_unit_vector, dst_circle_radius, cos_dst_circle_radius, sin_dst_circle_radius))
+            continue;
+        for (i = tile_num_children[tile_indx]-1; i >= 0; i --)
+            tile_stack[num_tiles_in_stack++] = tile_first_child[tile_indx] + i;
+        for (i = tile_first_cell[tile_indx]; i < tile_first_cell[tile_indx]+tile_num_cells[tile_indx]; i ++)
+            if (dst_cell->check_overlapping(cells_ptr[i], accurately_match)) {
+                index_buffer[num_overlapping_cells++] = sorted_cell_indexes[i];
+                if (early_quit)
+                    break;
+            }
+    }
     
     if (early_quit)
         EXECUTION_REPORT(REPORT_ERROR, -1, num_overlapping_cells <= 1, "Software error2 in H2D_grid_cell_search_engine::search_overlapping_cells %d", num_overlapping_cells);
@@ -802,12 +912,15 @@ void H2D_grid_cell_search_engine::update(const bool *new_masks)
 
     for (int i = 0; i < remap_grid->get_grid_size(); i ++)
         cells[i]->set_mask(new_masks[i]);
+    if (sorted_cell_masks != NULL)
+        for (int i = 0; i < num_cells; i ++)
+            sorted_cell_masks[i] = cells_ptr[i]->get_mask();
 }
 
 
 const H2D_grid_cell_search_cell* H2D_grid_cell_search_engine::get_cell(int cell_index) const
 {
-        EXECUTION_REPORT(REPORT_ERROR, -1, root_tile == NULL, "Software error1 in H2D_grid_cell_search_engine::get_cell");
+        EXECUTION_REPORT(REPORT_ERROR, -1, num_tiles == 0, "Software error1 in H2D_grid_cell_search_engine::get_cell");
         EXECUTION_REPORT(REPORT_ERROR, -1, cell_index >= 0 && cell_index < remap_grid->get_grid_size(), "Software error2 in H2D_grid_cell_search_engine::get_cell");
         EXECUTION_REPORT(REPORT_ERROR, -1, cells[cell_index]->get_mask(), "Software error3 in H2D_grid_cell_search_engine::get_cell");
 
@@ -45,6 +45,7 @@ class H2D_grid_cell_search_cell
         int cell_index;
         double center_lon;
         double center_lat;
+        double center_unit_vector[3];
         int num_vertex;
         double *vertex_lons;
         double *vertex_lats;
@@ -67,6 +68,7 @@ class H2D_grid_cell_search_cell
         ~H2D_grid_cell_search_cell();
         double get_center_lon() const { return center_lon; }
         double get_center_lat() const { return center_lat; }
+        const double *get_center_unit_vector() const { return center_unit_vector; }
         int get_num_vertex() const { return num_vertex; }
         int get_cell_index() const { return cell_index; }
         double get_vertex_lon(int indx) const ;
@@ -96,14 +98,14 @@ class H2D_grid_cell_search_tile
         double dlon;
         double dlat;
 
+        friend class H2D_grid_cell_search_engine;
+
     public:
         bool has_cell_index(int);
         H2D_grid_cell_search_tile(int, H2D_grid_cell_search_cell**, H2D_grid_cell_search_cell**, long*, H2D_grid_cell_search_tile*, double, double, double, double);
         ~H2D_grid_cell_search_tile();
         void divide_tile();
         void compute_bounding_circle();
-        bool search_points_within_distance(double, double, double, int&, long*, double*, bool);
-        void search_overlapping_cells(int&, long*, const H2D_grid_cell_search_cell*, bool, bool);
 };
 
 
@@ -116,9 +118,27 @@ class H2D_grid_cell_search_engine
         H2D_grid_cell_search_cell **cells_buffer;
         long *index_buffer;
         double *dist_buffer;
-        H2D_grid_cell_search_tile *root_tile;
         double dist_threshold;
         int num_cells;
+        int num_tiles;                          // the tiles are stored breadth-first, so that the children of a tile are contiguous
+        double *tile_center_unit_vectors;
+        double *tile_circle_radius;
+        double *tile_cos_circle_radius;
+        double *tile_sin_circle_radius;
+        int *tile_first_child;
+        int *tile_num_children;
+        int *tile_first_cell;                   // the cells in cells_ptr are sorted by leaf tiles
+        int *tile_num_cells;
+        int *tile_stack;
+        double *sorted_cell_unit_vectors;
+        double *sorted_cell_center_lons;
+        double *sorted_cell_center_lats;
+        long *sorted_cell_indexes;
+        bool *sorted_cell_masks;
+
+        void flatten_search_tiles(H2D_grid_cell_search_tile*);
+        bool is_tile_out_of_circle(int, const double*, double, double, double) const;
+        bool search_points_within_distance(double, double, double, const double*, int&, long*, double*, bool);
         
     public:
         H2D_grid_cell_search_engine(const Remap_grid_class*, const double*, const double*, const bool*, const bool*, int, const double*, const double*, int, bool);
@@ -156,6 +156,25 @@ void IO_basis::copy_field_data_for_IO(Remap_grid_data_class *field_data_in_appli
 }
 
 
+void IO_basis::copy_data_buf_for_IO(const char *data_type, void *data_buf, double fill_value, long size, bool is_restart_field)
+{
+    if (is_restart_field)
+        return;
+
+    if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        copy_data_values_for_IO((double*)data_buf, (double)fill_value, (double*)data_buf, (double)fill_value, NULL, size, is_restart_field);
+    else if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+        copy_data_values_for_IO((float*)data_buf, (float)fill_value, (float*)data_buf, (float)fill_value, NULL, size, is_restart_field);
+    else if (words_are_the_same(data_type, DATA_TYPE_INT))
+        copy_data_values_for_IO((int*)data_buf, (int)fill_value, (int*)data_buf, (int)fill_value, NULL, size, is_restart_field);
+    else if (words_are_the_same(data_type, DATA_TYPE_SHORT))
+        copy_data_values_for_IO((short*)data_buf, (short)fill_value, (short*)data_buf, (short)fill_value, NULL, size, is_restart_field);
+    else if (words_are_the_same(data_type, DATA_TYPE_BOOL))
+        copy_data_values_for_IO((bool*)data_buf, (bool)fill_value, (bool*)data_buf, (bool)fill_value, NULL, size, is_restart_field);
+    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "C-Coupler error in copy_data_buf_for_IO\n");
+}
+
+
 int IO_basis::get_recorded_grid_num(Remap_grid_class *grid)
 {
     for (int i = 0; i < recorded_grids.size(); i ++)
@@ -38,7 +38,7 @@ class IO_basis
         
     public:
         IO_basis(){}
-        ~IO_basis(){}
+        virtual ~IO_basis(){}
         bool match_IO_object(const char*);
         const char* get_file_name() { return file_name; }
         char *get_file_type() { return file_type; }
@@ -47,6 +47,7 @@ class IO_basis
         virtual long get_dimension_size(const char*, MPI_Comm, bool) = 0;
         Remap_grid_data_class *generate_field_data_for_IO(Remap_grid_data_class*, bool);
         void copy_field_data_for_IO(Remap_grid_data_class*, Remap_grid_data_class*, bool);
+        void copy_data_buf_for_IO(const char*, void*, double, long, bool);
         int get_recorded_grid_num(Remap_grid_class*);
 };
 
@@ -19,6 +19,10 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 IO_binary::IO_binary(const char *object_name, const char *file_name, const char *format)
@@ -88,6 +92,7 @@ void IO_binary::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
 {
     char *flat_array;
     long array_size;
+    Binary_weight_file_header file_header;
 
 
     EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(open_format, "w"), "can not write to binary file %s: %s, whose open format is not write\n", object_name, file_name);
@@ -95,7 +100,14 @@ void IO_binary::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
     
     if (execution_phase_number == 1) {
         remap_weights->write_remap_weights_into_array(&flat_array, array_size, true);
+        memset(&file_header, 0, sizeof(Binary_weight_file_header));
+        strcpy(file_header.magic, BINARY_WEIGHT_FILE_MAGIC);
+        file_header.version = BINARY_WEIGHT_FILE_VERSION;
+        file_header.alignment = REMAP_WEIGHT_ARRAY_ALIGNMENT;
+        file_header.payload_size = array_size;
+        file_header.byte_order_mark = BINARY_WEIGHT_FILE_BYTE_ORDER_MARK;
         fp_binary = fopen(file_name, "w+");
+        fwrite(&file_header, sizeof(Binary_weight_file_header), 1, fp_binary);
         fwrite(flat_array, array_size, 1, fp_binary);
         delete [] flat_array;
         fclose(fp_binary);
@@ -105,7 +117,10 @@ void IO_binary::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
 
 void IO_binary::read_remap_weights(Remap_weight_of_strategy_class *remap_weights, Remap_strategy_class *remap_strategy, bool read_weight_values)
 {    
-    long array_size;
+    Binary_weight_file_header *file_header;
+    struct stat file_status;
+    void *mapped_file;
+    int file_descriptor;
     
 
     EXECUTION_REPORT(REPORT_ERROR, -1, remap_weights != NULL, "remap software error1 in read_remap_weights binary\n");
@@ -114,16 +129,24 @@ void IO_binary::read_remap_weights(Remap_weight_of_strategy_class *remap_weights
     else EXECUTION_REPORT(REPORT_ERROR, -1, true, "remapping weight values will not be read into %s", remap_weights->get_object_name());
 
     if (execution_phase_number == 1) {
-        fp_binary = fopen(file_name, "r"); 
-        fseek(fp_binary, 0, SEEK_END);
-        long array_size = ftell(fp_binary);
-        int num_proc_computing_node_comp_group, current_proc_id_computing_node_comp_group = 0;
-        EXECUTION_REPORT(REPORT_ERROR, -1, false, "to be rewritten: IO_binary::read_remap_weights");
-        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "begin reading file of weights values at process %d", current_proc_id_computing_node_comp_group); 
-        fseek(fp_binary, 0, SEEK_SET);
-        remap_weights->read_remap_weights_from_array(NULL, fp_binary, array_size, true, NULL, read_weight_values);
-        fclose(fp_binary);
-        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish reading file of weights values at process %d", current_proc_id_computing_node_comp_group); 
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "begin mapping file of weights values %s", file_name); 
+        file_descriptor = open(file_name, O_RDONLY);
+        EXECUTION_REPORT(REPORT_ERROR, -1, file_descriptor != -1, "fail to open the binary file of remapping weights %s", file_name);
+        EXECUTION_REPORT(REPORT_ERROR, -1, fstat(file_descriptor, &file_status) == 0 && file_status.st_size >= BINARY_WEIGHT_FILE_HEADER_SIZE, "the binary file of remapping weights %s is too small to have a file header", file_name);
+        mapped_file = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        close(file_descriptor);
+        EXECUTION_REPORT(REPORT_ERROR, -1, mapped_file != MAP_FAILED, "fail to map the binary file of remapping weights %s into memory", file_name);
+        file_header = (Binary_weight_file_header*) mapped_file;
+        EXECUTION_REPORT(REPORT_ERROR, -1, words_are_the_same(file_header->magic, BINARY_WEIGHT_FILE_MAGIC), "the file %s is not a binary file of remapping weights generated by C-Coupler", file_name);
+        EXECUTION_REPORT(REPORT_ERROR, -1, file_header->version == BINARY_WEIGHT_FILE_VERSION && file_header->alignment == REMAP_WEIGHT_ARRAY_ALIGNMENT, "the binary file of remapping weights %s has version %d (alignment %d), which is not supported by this version of C-Coupler (version %d, alignment %d)", file_name, file_header->version, file_header->alignment, BINARY_WEIGHT_FILE_VERSION, REMAP_WEIGHT_ARRAY_ALIGNMENT);
+        EXECUTION_REPORT(REPORT_ERROR, -1, file_header->byte_order_mark == BINARY_WEIGHT_FILE_BYTE_ORDER_MARK, "the binary file of remapping weights %s was generated on a machine with different byte order", file_name);
+        EXECUTION_REPORT(REPORT_ERROR, -1, file_header->payload_size == file_status.st_size-BINARY_WEIGHT_FILE_HEADER_SIZE, "the binary file of remapping weights %s is truncated", file_name);
+        if (read_weight_values)
+            remap_weights->set_mapped_weight_file(new Mapped_weight_file(mapped_file, file_status.st_size));
+        remap_weights->read_remap_weights_from_array((const char*)mapped_file+BINARY_WEIGHT_FILE_HEADER_SIZE, NULL, file_header->payload_size, true, NULL, read_weight_values);
+        if (!read_weight_values)
+            munmap(mapped_file, file_status.st_size);
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish mapping file of weights values %s", file_name); 
     }
 }
 
@@ -16,6 +16,23 @@
 #include "remap_weight_of_strategy_class.h"
 
 
+#define BINARY_WEIGHT_FILE_MAGIC            "CCPLWGT"
+#define BINARY_WEIGHT_FILE_VERSION          1
+#define BINARY_WEIGHT_FILE_BYTE_ORDER_MARK  0x0102030405060708L
+#define BINARY_WEIGHT_FILE_HEADER_SIZE      REMAP_WEIGHT_ARRAY_ALIGNMENT
+
+
+struct Binary_weight_file_header
+{
+    char magic[8];
+    int version;
+    int alignment;
+    long payload_size;
+    long byte_order_mark;
+    char reserved[BINARY_WEIGHT_FILE_HEADER_SIZE-8-2*sizeof(int)-2*sizeof(long)];
+};
+
+
 class IO_binary: public IO_basis
 {
     private:
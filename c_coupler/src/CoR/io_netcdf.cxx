@@ -43,7 +43,9 @@ IO_netcdf::IO_netcdf(const char *object_name, const char *file_name, const char
         report_nc_error();
         nc_enddef(ncfile_id);        
     }
-    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "the format of openning netcdf file must be read or write (\"r\" or \"w\")\n");
+    else if (words_are_the_same(format, "a"))
+        rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "the format of openning netcdf file must be read, write or append (\"r\", \"w\" or \"a\")\n");
     report_nc_error();
 
     rcode = nc_close(ncfile_id);
@@ -379,6 +381,54 @@ void IO_netcdf::write_grid(Remap_grid_class *associated_grid, bool write_grid_na
 }
 
 
+void IO_netcdf::define_field_var(Remap_grid_data_class *field_data, const char *var_name, int num_dims, int *dim_ncids, int *var_ncid)
+{
+    nc_type nc_data_type;
+    int i;
+
+
+    rcode = nc_inq_varid(ncfile_id, var_name, var_ncid);
+    if (rcode == NC_ENOTVAR) {
+        rcode = nc_redef(ncfile_id);
+        report_nc_error();
+        datatype_from_application_to_netcdf(field_data->get_grid_data_field()->data_type_in_IO_file, &nc_data_type);
+        rcode = nc_def_var(ncfile_id, var_name, nc_data_type, num_dims, dim_ncids, var_ncid);
+        report_nc_error();
+        for (i = 0; i < field_data->get_grid_data_field()->field_attributes.size(); i ++) {
+            datatype_from_application_to_netcdf(field_data->get_grid_data_field()->field_attributes[i].attribute_type, &nc_data_type);
+            switch (nc_data_type) {
+                case NC_BYTE:
+                case NC_CHAR:
+                    rcode = nc_put_att_text(ncfile_id, *var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name,
+                                            field_data->get_grid_data_field()->field_attributes[i].attribute_size, field_data->get_grid_data_field()->field_attributes[i].attribute_value);
+                    break;
+                case NC_SHORT:
+                    rcode = nc_put_att_short(ncfile_id, *var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
+                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (short*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
+                    break;
+                case NC_INT:
+                    rcode = nc_put_att_int(ncfile_id, *var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
+                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (int*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
+                    break;
+                case NC_FLOAT:
+                    rcode = nc_put_att_float(ncfile_id, *var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
+                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (float*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
+                    break;
+                case NC_DOUBLE:
+                    rcode = nc_put_att_double(ncfile_id, *var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
+                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (double*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
+                    break;
+                default:
+                    EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error in define_field_var\n");
+            }
+            report_nc_error();
+        }
+        nc_enddef(ncfile_id);
+        report_nc_error();
+    }
+}
+
+
 void IO_netcdf::write_field_data(Remap_grid_data_class *field_data, 
                                 Remap_grid_class *interchange_grid,
                                 bool is_grid_data, 
@@ -393,7 +443,6 @@ void IO_netcdf::write_field_data(Remap_grid_data_class *field_data,
     char tmp_string[256];
     int var_ncid, dim_ncids[256];
     size_t starts[256], counts[256];
-    nc_type nc_data_type;
 
 
     if (!is_grid_data)
@@ -484,45 +533,7 @@ void IO_netcdf::write_field_data(Remap_grid_data_class *field_data,
         counts[0] = 1;
     }
 
-    rcode = nc_inq_varid(ncfile_id, tmp_string, &var_ncid);
-    if (rcode == NC_ENOTVAR) {
-        rcode = nc_redef(ncfile_id);
-        report_nc_error();
-        datatype_from_application_to_netcdf(field_data->get_grid_data_field()->data_type_in_IO_file, &nc_data_type);
-        rcode = nc_def_var(ncfile_id, tmp_string, nc_data_type, num_dims, dim_ncids, &var_ncid);
-        report_nc_error();
-        for (i = 0; i < field_data->get_grid_data_field()->field_attributes.size(); i ++) {
-            datatype_from_application_to_netcdf(field_data->get_grid_data_field()->field_attributes[i].attribute_type, &nc_data_type);
-            switch (nc_data_type) {
-                case NC_BYTE:
-                case NC_CHAR:
-                    rcode = nc_put_att_text(ncfile_id, var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name,
-                                            field_data->get_grid_data_field()->field_attributes[i].attribute_size, field_data->get_grid_data_field()->field_attributes[i].attribute_value);
-                    break;
-                case NC_SHORT:
-                    rcode = nc_put_att_short(ncfile_id, var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
-                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (short*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
-                    break;
-                case NC_INT:
-                    rcode = nc_put_att_int(ncfile_id, var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
-                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (int*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
-                    break;
-                case NC_FLOAT:
-                    rcode = nc_put_att_float(ncfile_id, var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
-                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (float*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
-                    break;
-                case NC_DOUBLE:
-                    rcode = nc_put_att_double(ncfile_id, var_ncid, field_data->get_grid_data_field()->field_attributes[i].attribute_name, nc_data_type,
-                                             field_data->get_grid_data_field()->field_attributes[i].attribute_size, (double*)field_data->get_grid_data_field()->field_attributes[i].attribute_value);
-                    break;
-                default:
-                    EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error2 in write_field_data\n");
-            }
-            report_nc_error();
-        }
-        nc_enddef(ncfile_id);
-        report_nc_error();
-    }
+    define_field_var(field_data, tmp_string, num_dims, dim_ncids, &var_ncid);
 
     if (words_are_the_same(field_data->get_grid_data_field()->data_type_in_application, DATA_TYPE_BOOL)) {
         int *temp_buffer = new int [field_data->get_grid_data_field()->required_data_size];
@@ -548,20 +559,13 @@ void IO_netcdf::write_field_data(Remap_grid_data_class *field_data,
 }
 
 
-void IO_netcdf::write_grided_data(Remap_grid_data_class *grided_data, bool write_grid_name, int date, int datesec, bool is_restart_field)
+void IO_netcdf::update_time_record(int date, int datesec)
 {
     unsigned long starts, counts, dim_len;
     int current_date, current_datesec;
-    int time_var_id, date_var_id, datesec_var_id, tmp_var_id;;
-    Remap_grid_data_class *tmp_field_data_for_io;
+    int time_var_id, date_var_id, datesec_var_id;
 
 
-    if (execution_phase_number == 0)
-        return;
-    
-    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
-    report_nc_error();
-
     if (!io_with_time_info)
         EXECUTION_REPORT(REPORT_ERROR, -1, date == -1 && datesec == -1, "remap software error in write_grided_data \n");
     else {
@@ -617,6 +621,21 @@ void IO_netcdf::write_grided_data(Remap_grid_data_class *grided_data, bool write
             report_nc_error();
         }
     }
+}
+
+
+void IO_netcdf::write_grided_data(Remap_grid_data_class *grided_data, bool write_grid_name, int date, int datesec, bool is_restart_field)
+{
+    Remap_grid_data_class *tmp_field_data_for_io;
+
+
+    if (execution_phase_number == 0)
+        return;
+    
+    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    report_nc_error();
+
+    update_time_record(date, datesec);
 
     rcode = nc_close(ncfile_id);
     report_nc_error();
@@ -638,6 +657,249 @@ void IO_netcdf::write_grided_data(Remap_grid_data_class *grided_data, bool write
 }
 
 
+int IO_netcdf::define_grided_data(Remap_grid_data_class *grided_data, bool write_grid_name, int date, int datesec, char *var_name, long *dim_sizes, int &time_pos)
+{
+    int num_sized_sub_grids, num_dims, i, var_ncid, dim_ncids[256];
+    Remap_grid_class *sized_sub_grids[256];
+    long io_data_size;
+
+
+    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    report_nc_error();
+
+    update_time_record(date, datesec);
+
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+
+    write_grid(grided_data->get_coord_value_grid(), write_grid_name, false);
+
+    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    report_nc_error();
+
+    if (strlen(grided_data->get_grid_data_field()->data_type_in_IO_file) == 0)
+        strcpy(grided_data->get_grid_data_field()->data_type_in_IO_file, grided_data->get_grid_data_field()->data_type_in_application);
+    if (!words_are_the_same(grided_data->get_grid_data_field()->field_name_in_IO_file, "\0"))
+        strcpy(var_name, grided_data->get_grid_data_field()->field_name_in_IO_file);
+    else strcpy(var_name, grided_data->get_grid_data_field()->field_name_in_application);
+
+    rcode = nc_inq_varid(ncfile_id, var_name, &var_ncid);
+    EXECUTION_REPORT(REPORT_WARNING, -1, rcode == NC_ENOTVAR || io_with_time_info,
+                     "field data \"%s\" has been written to netcdf file \"%s\" before. The old data will be overwritten\n",
+                     grided_data->get_grid_data_field()->field_name_in_application, file_name);
+
+    if (sized_grids_map.find(grided_data->get_coord_value_grid()) != sized_grids_map.end()) {
+        num_sized_sub_grids = 1;
+        sized_sub_grids[0] = grided_data->get_coord_value_grid();
+    }
+    else grided_data->get_coord_value_grid()->get_sized_sub_grids(&num_sized_sub_grids, sized_sub_grids);
+    num_dims = 0;
+    if (io_with_time_info)
+        dim_ncids[num_dims++] = time_dim_id;
+    for (i = num_sized_sub_grids-1, io_data_size = 1; i >= 0; i --) {
+        EXECUTION_REPORT(REPORT_ERROR, -1, sized_grids_map.find(sized_sub_grids[i]) != sized_grids_map.end(), "remap software error1 in define_grided_data\n");
+        dim_ncids[num_dims++] = sized_grids_map[sized_sub_grids[i]];
+        dim_sizes[num_sized_sub_grids-1-i] = sized_sub_grids[i]->get_grid_size();
+        io_data_size *= sized_sub_grids[i]->get_grid_size();
+    }
+    EXECUTION_REPORT(REPORT_ERROR, -1, grided_data->get_grid_data_field()->required_data_size == io_data_size, "C-Coupler error: the data size in field for writing and IO file must be the same: %ld : %ld", grided_data->get_grid_data_field()->required_data_size, io_data_size);
+    define_field_var(grided_data, var_name, num_dims, dim_ncids, &var_ncid);
+
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+
+    time_pos = io_with_time_info? time_count - 1 : -1;
+
+    return num_sized_sub_grids;
+}
+
+
+void IO_netcdf::put_vara_data(int var_ncid, const char *data_type, size_t *starts, size_t *counts, long data_size, void *data_buf)
+{
+    if (words_are_the_same(data_type, DATA_TYPE_BOOL)) {
+        int *temp_buffer = new int [data_size];
+        for (long i = 0; i < data_size; i ++)
+            if (((bool*)data_buf)[i])
+                temp_buffer[i] = 1;
+            else temp_buffer[i] = 0;
+        rcode = nc_put_vara_int(ncfile_id, var_ncid, starts, counts, temp_buffer);
+        delete [] temp_buffer;
+    }
+    else if (words_are_the_same(data_type, DATA_TYPE_CHAR))
+        rcode = nc_put_vara_schar(ncfile_id, var_ncid, starts, counts, (signed char *) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_FLOAT)) 
+        rcode = nc_put_vara_float(ncfile_id, var_ncid, starts, counts, (float*) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_INT))
+        rcode = nc_put_vara_int(ncfile_id, var_ncid, starts, counts, (int *) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_SHORT))
+        rcode = nc_put_vara_short(ncfile_id, var_ncid, starts, counts, (short *) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        rcode = nc_put_vara_double(ncfile_id, var_ncid, starts, counts, (double*) data_buf);    
+    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error in put_vara_data\n");
+    report_nc_error(); 
+}
+
+
+void IO_netcdf::get_vara_data(int var_ncid, const char *data_type, size_t *starts, size_t *counts, void *data_buf)
+{
+    if (words_are_the_same(data_type, DATA_TYPE_FLOAT)) 
+        rcode = nc_get_vara_float(ncfile_id, var_ncid, starts, counts, (float*) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_INT))
+        rcode = nc_get_vara_int(ncfile_id, var_ncid, starts, counts, (int *) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_SHORT))
+        rcode = nc_get_vara_short(ncfile_id, var_ncid, starts, counts, (short *) data_buf);
+    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        rcode = nc_get_vara_double(ncfile_id, var_ncid, starts, counts, (double*) data_buf);    
+    else EXECUTION_REPORT(REPORT_ERROR, -1, false, "remap software error in get_vara_data\n");
+    report_nc_error(); 
+}
+
+
+/* Get the largest hyperslab at the beginning of the run [offset, offset+remain) of
+   the flattened field, and return the number of data points in the hyperslab */
+long IO_netcdf::get_run_hyperslab(long offset, long remain, int num_dims, const long *dim_sizes, const long *strides, int dim_start, size_t *starts, size_t *counts)
+{
+    long index, num_blocks;
+    int j, k;
+
+
+    for (j = 0; j < num_dims-1; j ++)
+        if (offset % strides[j] == 0 && remain >= strides[j])
+            break;
+    index = (offset / strides[j]) % dim_sizes[j];
+    num_blocks = remain / strides[j];
+    if (num_blocks > dim_sizes[j] - index)
+        num_blocks = dim_sizes[j] - index;
+    for (k = 0; k < num_dims; k ++) {
+        starts[dim_start+k] = (offset / strides[k]) % dim_sizes[k];
+        if (k < j)
+            counts[dim_start+k] = 1;
+        else if (k == j)
+            counts[dim_start+k] = num_blocks;
+        else counts[dim_start+k] = dim_sizes[k];
+    }
+
+    return num_blocks*strides[j];
+}
+
+
+/* Write a set of runs of a field defined by define_grided_data. Each run is a
+   contiguous range of the flattened (time-excluded) field and is split into the
+   fewest hyperslabs that nc_put_vara can accept */
+void IO_netcdf::write_field_data_runs(const char *var_name, const char *data_type, void *data_buf, int time_pos, int num_dims, const long *dim_sizes, int num_runs, const long *runs_offset, const long *runs_length)
+{
+    size_t starts[256], counts[256];
+    long strides[256], offset, remain, slab_size;
+    int var_ncid, dim_start, i, j;
+    char *data_ptr = (char*) data_buf;
+    int data_type_size = get_data_type_size(data_type);
+
+
+    if (execution_phase_number == 0)
+        return;
+
+    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    report_nc_error();
+    rcode = nc_inq_varid(ncfile_id, var_name, &var_ncid);
+    report_nc_error();
+
+    dim_start = 0;
+    if (time_pos >= 0) {
+        starts[0] = time_pos;
+        counts[0] = 1;
+        dim_start = 1;
+    }
+    strides[num_dims-1] = 1;
+    for (j = num_dims-2; j >= 0; j --)
+        strides[j] = strides[j+1] * dim_sizes[j+1];
+
+    for (i = 0; i < num_runs; i ++) {
+        offset = runs_offset[i];
+        remain = runs_length[i];
+        while (remain > 0) {
+            slab_size = get_run_hyperslab(offset, remain, num_dims, dim_sizes, strides, dim_start, starts, counts);
+            put_vara_data(var_ncid, data_type, starts, counts, slab_size, data_ptr);
+            data_ptr += slab_size*data_type_size;
+            offset += slab_size;
+            remain -= slab_size;
+        }
+    }
+
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+}
+
+
+/* Read a set of runs of a field from the file, where each run is a contiguous range 
+   of the flattened (time-excluded) field. The data of the runs are stored one after 
+   another in data_buf, and netCDF converts them into the given numeric data type */
+bool IO_netcdf::read_field_data_runs(const char *var_name, const char *data_type, void *data_buf, int time_pos, long required_data_size, int num_runs, const long *runs_offset, const long *runs_length, bool check_existence)
+{
+    size_t starts[256], counts[256];
+    long dim_sizes[256], strides[256], data_size, offset, remain, slab_size;
+    int var_ncid, num_dims, dim_start, dimension_ids[256], i, j;
+    size_t dimension_size;
+    char *data_ptr = (char*) data_buf;
+    int data_type_size = get_data_type_size(data_type);
+
+
+    rcode = nc_open(file_name, NC_NOWRITE, &ncfile_id);
+    report_nc_error();
+    rcode = nc_inq_varid(ncfile_id, var_name, &var_ncid);
+    if (!check_existence && rcode == NC_ENOTVAR) {
+        EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Does not find the field \"%s\" in the data file \"%s\"", var_name, file_name);
+        rcode = nc_close(ncfile_id);
+        report_nc_error();
+        return false;
+    }
+    report_nc_error();
+    rcode = nc_inq_varndims(ncfile_id, var_ncid, &num_dims);
+    report_nc_error();
+    rcode = nc_inq_vardimid(ncfile_id, var_ncid, dimension_ids);
+    report_nc_error();
+
+    dim_start = 0;
+    if (time_pos != -1) {
+        rcode = nc_inq_dimlen(ncfile_id, dimension_ids[0], &dimension_size);
+        report_nc_error();
+        EXECUTION_REPORT(REPORT_ERROR, -1, time_pos >= 0 && time_pos < dimension_size, "C-Coupler error in IO_netcdf::read_field_data_runs");
+        starts[0] = time_pos;
+        counts[0] = 1;
+        dim_start = 1;
+    }
+    for (j = dim_start, data_size = 1; j < num_dims; j ++) {
+        rcode = nc_inq_dimlen(ncfile_id, dimension_ids[j], &dimension_size);
+        report_nc_error();
+        dim_sizes[j-dim_start] = dimension_size;
+        data_size *= dimension_size;
+    }
+    num_dims -= dim_start;
+    EXECUTION_REPORT(REPORT_ERROR, -1, data_size == required_data_size, "the data size of field \"%s\" in netcdf file \"%s\" is different from of the data size determined by grid\n", var_name, file_name);
+
+    if (num_dims > 0) {
+        strides[num_dims-1] = 1;
+        for (j = num_dims-2; j >= 0; j --)
+            strides[j] = strides[j+1] * dim_sizes[j+1];
+    }
+    for (i = 0; i < num_runs; i ++) {
+        offset = runs_offset[i];
+        remain = runs_length[i];
+        while (remain > 0) {
+            slab_size = get_run_hyperslab(offset, remain, num_dims, dim_sizes, strides, dim_start, starts, counts);
+            get_vara_data(var_ncid, data_type, starts, counts, data_ptr);
+            data_ptr += slab_size*data_type_size;
+            offset += slab_size;
+            remain -= slab_size;
+        }
+    }
+
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+
+    return true;
+}
+
+
 long IO_netcdf::get_dimension_size(const char *dim_name, MPI_Comm comm, bool is_root_proc)
 {
     int dimension_id;
@@ -664,6 +926,14 @@ long IO_netcdf::get_dimension_size(const char *dim_name, MPI_Comm comm, bool is_
 
 
 void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weights)
+{
+    write_remap_weights(remap_weights, -1);
+}
+
+
+/* When num_overall_weights is larger than the number of weights in the sparse matrix, only the dimension "n_s" is 
+    defined for the weights, and the processes write their own weights later by write_remap_weights_slab */
+void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weights, long num_overall_weights)
 {
     Remap_grid_class *remap_grid_src, *remap_grid_dst, *leaf_grids[256];
     int dim_ncid_n_a, dim_ncid_n_b, dim_ncid_n_s, dim_ncid_nv_a, dim_ncid_nv_b;
@@ -708,6 +978,8 @@ void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
         EXECUTION_REPORT(REPORT_ERROR, -1, remap_operator->get_num_remap_weights_groups() == 1,
                      "for SCRIP format of remap weights, we only support horizontal 2D remap of only one remap algorithm\n");
         weight_sparse_matrix = remap_operator->get_remap_weights_group(0);
+        if (num_overall_weights == -1)
+            num_overall_weights = weight_sparse_matrix->get_num_weights();
         area_or_volumn_a = remap_weights->get_data_grid_src()->get_area_or_volumn();
         area_or_volumn_b = remap_weights->get_data_grid_dst()->get_area_or_volumn();
 		if (remap_weights->get_remap_strategy() != NULL) 
@@ -719,7 +991,7 @@ void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
         report_nc_error();
         rcode = nc_def_dim(ncfile_id, "n_b", remap_weights->get_data_grid_dst()->get_grid_size(), &dim_ncid_n_b);
         report_nc_error();
-        rcode = nc_def_dim(ncfile_id, "n_s", weight_sparse_matrix->get_num_weights(), &dim_ncid_n_s);
+        rcode = nc_def_dim(ncfile_id, "n_s", num_overall_weights, &dim_ncid_n_s);
         report_nc_error();
         rcode = nc_def_var(ncfile_id, "col", NC_INT, 1, &dim_ncid_n_s, &col_id);
         report_nc_error();
@@ -770,18 +1042,20 @@ void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
         report_nc_error();
         rcode = nc_enddef(ncfile_id);
         report_nc_error();
-        temp_int_values = new int [weight_sparse_matrix->get_num_weights()];
-        for (j = 0; j < weight_sparse_matrix->get_num_weights(); j ++)
-            temp_int_values[j] = weight_sparse_matrix->get_indexes_src_grid()[j] + 1;
-        rcode = nc_put_var_int(ncfile_id, col_id, temp_int_values);
-        report_nc_error();
-        for (j = 0; j < weight_sparse_matrix->get_num_weights(); j ++)
-            temp_int_values[j] = weight_sparse_matrix->get_indexes_dst_grid()[j] + 1;
-        rcode = nc_put_var_int(ncfile_id, row_id, temp_int_values);
-        delete [] temp_int_values;
-        report_nc_error();
-        rcode = nc_put_var_double(ncfile_id, S_id, weight_sparse_matrix->get_weight_values());
-        report_nc_error();
+        if (weight_sparse_matrix->get_num_weights() == num_overall_weights) {
+            temp_int_values = new int [weight_sparse_matrix->get_num_weights()];
+            for (j = 0; j < weight_sparse_matrix->get_num_weights(); j ++)
+                temp_int_values[j] = weight_sparse_matrix->get_indexes_src_grid()[j] + 1;
+            rcode = nc_put_var_int(ncfile_id, col_id, temp_int_values);
+            report_nc_error();
+            for (j = 0; j < weight_sparse_matrix->get_num_weights(); j ++)
+                temp_int_values[j] = weight_sparse_matrix->get_indexes_dst_grid()[j] + 1;
+            rcode = nc_put_var_int(ncfile_id, row_id, temp_int_values);
+            delete [] temp_int_values;
+            report_nc_error();
+            rcode = nc_put_var_double(ncfile_id, S_id, weight_sparse_matrix->get_weight_values());
+            report_nc_error();
+        }
 		if (area_or_volumn_a != NULL) {
         	rcode = nc_put_var_double(ncfile_id, area_a_id, area_or_volumn_a);
 	        report_nc_error();
@@ -850,6 +1124,56 @@ void IO_netcdf::write_remap_weights(Remap_weight_of_strategy_class *remap_weight
 }
 
 
+/* The weight file defined by write_remap_weights is opened once for all slabs of weights written by write_remap_weights_slab */
+void IO_netcdf::open_remap_weights_for_slabs()
+{
+    rcode = nc_open(file_name, NC_WRITE, &ncfile_id);
+    report_nc_error();
+}
+
+
+void IO_netcdf::close_remap_weights_for_slabs()
+{
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+}
+
+
+/* Writes the weights at [weights_offset, weights_offset+num_weights) of "col", "row" and "S" into the weight file 
+    opened by open_remap_weights_for_slabs */
+void IO_netcdf::write_remap_weights_slab(long weights_offset, long num_weights, const long *indexes_src, const long *indexes_dst, const double *weight_values)
+{
+    size_t starts[1], counts[1];
+    int col_id, row_id, S_id;
+    int *temp_int_values;
+
+
+    if (num_weights == 0)
+        return;
+
+    rcode = nc_inq_varid(ncfile_id, "col", &col_id);
+    report_nc_error();
+    rcode = nc_inq_varid(ncfile_id, "row", &row_id);
+    report_nc_error();
+    rcode = nc_inq_varid(ncfile_id, "S", &S_id);
+    report_nc_error();
+    starts[0] = weights_offset;
+    counts[0] = num_weights;
+    temp_int_values = new int [num_weights];
+    for (long j = 0; j < num_weights; j ++)
+        temp_int_values[j] = indexes_src[j] + 1;
+    rcode = nc_put_vara_int(ncfile_id, col_id, starts, counts, temp_int_values);
+    report_nc_error();
+    for (long j = 0; j < num_weights; j ++)
+        temp_int_values[j] = indexes_dst[j] + 1;
+    rcode = nc_put_vara_int(ncfile_id, row_id, starts, counts, temp_int_values);
+    report_nc_error();
+    delete [] temp_int_values;
+    rcode = nc_put_vara_double(ncfile_id, S_id, starts, counts, weight_values);
+    report_nc_error();
+}
+
+
 void IO_netcdf::put_global_attr(const char *text_title, const void *attr_value, const char *local_data_type, const char *nc_data_type, int size)
 {
     int nc_datatype;
@@ -957,6 +1281,46 @@ bool IO_netcdf::get_file_field_attribute(const char *field_name, const char *att
 }
 
 
+void IO_netcdf::read_file_field_slab(const char *field_name, const char *required_data_type, long field_size, long start, long count, void *data_buf)
+{
+    int variable_id, num_dims, dim_id;
+    size_t dim_len, starts[1], counts[1];
+    nc_type nc_var_type;
+    char data_type[NAME_STR_SIZE];
+
+
+    rcode = nc_open(file_name, NC_NOWRITE, &ncfile_id);
+    report_nc_error();
+    rcode = nc_inq_varid(ncfile_id, field_name, &variable_id);
+    EXECUTION_REPORT(REPORT_ERROR, -1, rcode == NC_NOERR, "Error happens when reading the variable \"%s\" from the netcdf file \"%s\": the variable does not exist. Please verify.", field_name, file_name);
+    rcode = nc_inq_varndims(ncfile_id, variable_id, &num_dims);
+    report_nc_error();
+    EXECUTION_REPORT(REPORT_ERROR, -1, num_dims == 1, "Error happens when reading the variable \"%s\" from the netcdf file \"%s\": the variable must be one-dimensional. Please verify.", field_name, file_name);
+    rcode = nc_inq_vardimid(ncfile_id, variable_id, &dim_id);
+    report_nc_error();
+    rcode = nc_inq_dimlen(ncfile_id, dim_id, &dim_len);
+    report_nc_error();
+    rcode = nc_inq_vartype(ncfile_id, variable_id, &nc_var_type);
+    report_nc_error();
+    datatype_from_netcdf_to_application(nc_var_type, data_type, field_name);
+    EXECUTION_REPORT(REPORT_ERROR, -1, dim_len == field_size && words_are_the_same(data_type, required_data_type), "Error happens when reading the variable \"%s\" from the netcdf file \"%s\": wrong array size (should be %ld) or wrong data type (should be %s). Please verify.", field_name, file_name, field_size, required_data_type);
+    EXECUTION_REPORT(REPORT_ERROR, -1, start >= 0 && count >= 0 && start+count <= field_size, "Software error in IO_netcdf::read_file_field_slab: wrong slab");
+
+    if (count > 0) {
+        starts[0] = start;
+        counts[0] = count;
+        if (words_are_the_same(data_type, DATA_TYPE_INT))
+            rcode = nc_get_vara_int(ncfile_id, variable_id, starts, counts, (int*) data_buf);
+        else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+            rcode = nc_get_vara_double(ncfile_id, variable_id, starts, counts, (double*) data_buf);
+        else EXECUTION_REPORT(REPORT_ERROR, -1, false, "software error in IO_netcdf::read_file_field_slab: data type %s is not supported", data_type);
+        report_nc_error();
+    }
+    rcode = nc_close(ncfile_id);
+    report_nc_error();
+}
+
+
 bool IO_netcdf::get_file_field_string_attribute(const char *field_name, const char *attribute_name, char *attribute_value, char *data_type, MPI_Comm comm, bool is_root_proc)
 {
     int success;
@@ -39,6 +39,11 @@ class IO_netcdf: public IO_basis
         void datatype_from_application_to_netcdf(const char*, nc_type*);
         void report_nc_error();
         bool get_file_field_attribute(const char *, const char *, char *, char *);
+        void define_field_var(Remap_grid_data_class*, const char*, int, int*, int*);
+        void update_time_record(int, int);
+        void put_vara_data(int, const char*, size_t*, size_t*, long, void*);
+        void get_vara_data(int, const char*, size_t*, size_t*, void*);
+        long get_run_hyperslab(long, long, int, const long*, const long*, int, size_t*, size_t*);
 
     public:
         IO_netcdf(int);
@@ -46,11 +51,19 @@ class IO_netcdf: public IO_basis
         ~IO_netcdf();
         bool read_data(Remap_data_field*, int, bool);
         void write_grided_data(Remap_grid_data_class*, bool, int, int, bool);
+        int define_grided_data(Remap_grid_data_class*, bool, int, int, char*, long*, int&);
+        void write_field_data_runs(const char*, const char*, void*, int, int, const long*, int, const long*, const long*);
+        bool read_field_data_runs(const char*, const char*, void*, int, long, int, const long*, const long*, bool);
         void write_remap_weights(Remap_weight_of_strategy_class*);
+        void write_remap_weights(Remap_weight_of_strategy_class*, long);
+        void open_remap_weights_for_slabs();
+        void write_remap_weights_slab(long, long, const long*, const long*, const double*);
+        void close_remap_weights_for_slabs();
         long get_dimension_size(const char*, MPI_Comm, bool);
         void read_remap_weights(Remap_weight_of_strategy_class*, Remap_strategy_class*, bool);
         void put_global_attr(const char*, const void*, const char *, const char *, int);
         void read_file_field(const char*, void**, int*, char*, MPI_Comm, bool);
+        void read_file_field_slab(const char*, const char*, long, long, long, void*);
         bool get_file_field_string_attribute(const char*, const char *, char*, char *, MPI_Comm, bool);
         void write_grid(Remap_grid_class*, bool, bool);
 };
@@ -269,6 +269,74 @@ void Remap_grid_data_class::interchange_grid_data(Remap_grid_class *interchange_
 }
 
 
+/* get_strided_view_of_grid_data describes how the field data would be accessed after interchange_grid_data(interchange_grid), 
+    without moving the data. It succeeds only when the sized sub grids of operator_grid are adjacent in the current layout 
+    and lead the interchanged layout, so that column j of the operator grid is the strided array starting at 
+    column_offsets[j] with the stride operator_stride */
+bool Remap_grid_data_class::get_strided_view_of_grid_data(Remap_grid_class *interchange_grid, Remap_grid_class *operator_grid, long &operator_stride, std::vector<long> &column_offsets)
+{
+    int i, j, k, num_sized_grids_interchange, num_sized_grids_operator, num_column_grids;
+    Remap_grid_class *sized_grids_interchange[256], *sized_grids_operator[256];
+    int interchanged_positions[256];
+    long strides[256], column_grid_strides[256], column_grid_sizes[256], column_grid_indexes[256];
+    long stride, num_columns, offset;
+
+
+    if (sized_grids.size() == 0)
+        return false;
+
+    for (i = 0, stride = 1; i < sized_grids.size(); i ++) {
+        strides[i] = stride;
+        stride *= sized_grids[i]->get_grid_size();
+    }
+
+    interchange_grid->get_sized_sub_grids(&num_sized_grids_interchange, sized_grids_interchange);
+    for (i = 0, k = 0; i < num_sized_grids_interchange; i ++) {
+        for (j = 0; j < sized_grids.size(); j ++)
+            if (sized_grids_interchange[i] == sized_grids[j])
+                break;
+        if (j < sized_grids.size())
+            interchanged_positions[k++] = j;
+    }
+    for (i = 0; i < sized_grids.size(); i ++) {
+        for (j = 0; j < num_sized_grids_interchange; j ++)
+            if (sized_grids[i] == sized_grids_interchange[j])
+                break;
+        if (j == num_sized_grids_interchange)
+            interchanged_positions[k++] = i;
+    }
+
+    operator_grid->get_sized_sub_grids(&num_sized_grids_operator, sized_grids_operator);
+    if (num_sized_grids_operator == 0 || num_sized_grids_operator > k)
+        return false;
+    for (i = 0; i < num_sized_grids_operator; i ++)
+        if (sized_grids[interchanged_positions[i]] != sized_grids_operator[i] || interchanged_positions[i] != interchanged_positions[0]+i)
+            return false;
+
+    operator_stride = strides[interchanged_positions[0]];
+    for (i = num_sized_grids_operator, num_column_grids = 0, num_columns = 1; i < k; i ++, num_column_grids ++) {
+        column_grid_strides[num_column_grids] = strides[interchanged_positions[i]];
+        column_grid_sizes[num_column_grids] = sized_grids[interchanged_positions[i]]->get_grid_size();
+        column_grid_indexes[num_column_grids] = 0;
+        num_columns *= column_grid_sizes[num_column_grids];
+    }
+    column_offsets.resize(num_columns);
+    for (j = 0, offset = 0; j < num_columns; j ++) {
+        column_offsets[j] = offset;
+        for (i = 0; i < num_column_grids; i ++) {
+            column_grid_indexes[i] ++;
+            offset += column_grid_strides[i];
+            if (column_grid_indexes[i] < column_grid_sizes[i])
+                break;
+            offset -= column_grid_strides[i]*column_grid_sizes[i];
+            column_grid_indexes[i] = 0;
+        }
+    }
+
+    return true;
+}
+
+
 void Remap_grid_data_class::reset_sized_grids(int num_sized_grids, Remap_grid_class **sized_grids)
 {
     long grid_size = 1;
@@ -50,6 +50,7 @@ class Remap_grid_data_class
         Remap_data_field *get_grid_data_field() const { return grid_data_field; }
         Remap_grid_data_class *duplicate_grid_data_field(Remap_grid_class*, int, bool, bool);
         void interchange_grid_data(Remap_grid_class*);
+        bool get_strided_view_of_grid_data(Remap_grid_class*, Remap_grid_class*, long&, std::vector<long>&);
         void reset_sized_grids(int, Remap_grid_class**);
         bool match_remap_grid_data(const char*);
         void transfer_field_attributes_to_another(Remap_grid_data_class*);
@@ -87,19 +87,29 @@ Remap_operator_bilinear::~Remap_operator_bilinear()
 }
 
 
+/* The dst cells are visited along a space-filling curve, so that successive searches touch neighbouring src cells. 
+    The search of every dst cell is still independent of the cells visited before it, which keeps the weights 
+    independent of the parallel decomposition */
 void Remap_operator_bilinear::calculate_remap_weights()
 {
+    long *dst_cell_indexes, dst_cell_index;
+
+
     iterative_threshold_distance = 1.0/6000.0;
     calculate_grids_overlaping();
     clear_remap_weight_info_in_sparse_matrix();
-    
-    for (long dst_cell_index = 0; dst_cell_index < dst_grid->get_grid_size(); dst_cell_index++) {
+
+    dst_cell_indexes = new long [get_size_of_dst_grid()];
+    get_dst_grid_cells_in_space_filling_curve_order(dst_cell_indexes);
+    for (long i = 0; i < get_size_of_dst_grid(); i ++) {
+        dst_cell_index = dst_cell_indexes[i];
         if (H2D_grid_decomp_mask != NULL && !H2D_grid_decomp_mask[dst_cell_index])
             continue;
         initialize_computing_remap_weights_of_one_cell();
         compute_remap_weights_of_one_dst_cell(dst_cell_index);    
         finalize_computing_remap_weights_of_one_cell();
     }
+    delete [] dst_cell_indexes;
 }
 
 
@@ -162,28 +172,18 @@ bool Remap_operator_bilinear::are_three_points_on_the_same_line(double *three_po
 }
 
 
-bool Remap_operator_bilinear::get_near_optimal_bilinear_box_recursively(double **distances_of_src_points_in_each_quadrant,
-                                                                        long **indexes_of_src_points_in_each_quadrant,
-                                                                        const int *num_src_points_in_each_quadrant,
-                                                                        int *iter_num_src_points_in_each_quadrant,
-                                                                        const double* dst_cell_center_values,
-                                                                        long *index_of_selected_src_point_in_each_quadrant,
-                                                                        int recursion_index)
+/* is_dst_point_in_bilinear_box sorts the 4 src points of a bilinear box and checks that the box encloses the dst point
+    without three points on the same line */
+bool Remap_operator_bilinear::is_dst_point_in_bilinear_box(const double *dst_cell_center_values, long *bilinear_box_src_cell_indexes)
 {
     int i, j;
     double src_cell_center_values[2];
     double bilinear_vertex_coord1_values[4], bilinear_vertex_coord2_values[4];
     double triangle_vertex_coord1_values[3], triangle_vertex_coord2_values[3];
-    double distance_of_selected_src_point_in_each_quadrant[4];
-    bool have_points_on_the_same_line;
-    int index_of_quadrant_id_for_distance_sorting[4];
-    int new_iter_num_src_points_in_each_quadrant[4];
-    double eps = 2.0e-9;
 
 
     for (i = 0; i < 4; i ++) {
-        index_of_selected_src_point_in_each_quadrant[i] = indexes_of_src_points_in_each_quadrant[i][iter_num_src_points_in_each_quadrant[i]];
-        get_cell_center_coord_values_of_src_grid(index_of_selected_src_point_in_each_quadrant[i], src_cell_center_values);
+        get_cell_center_coord_values_of_src_grid(bilinear_box_src_cell_indexes[i], src_cell_center_values);
         bilinear_vertex_coord1_values[i] = src_cell_center_values[0];
         bilinear_vertex_coord2_values[i] = src_cell_center_values[1];
     }
@@ -192,41 +192,60 @@ bool Remap_operator_bilinear::get_near_optimal_bilinear_box_recursively(double *
                           dst_cell_center_values[1],
                           bilinear_vertex_coord1_values,
                           bilinear_vertex_coord2_values,
-                          index_of_selected_src_point_in_each_quadrant,
+                          bilinear_box_src_cell_indexes,
                           4);     
     
-    if (is_point_in_2D_cell(dst_cell_center_values[0], 
-                            dst_cell_center_values[1],
-                            bilinear_vertex_coord1_values,
-                            bilinear_vertex_coord2_values,
-                            4,
-                            is_coord_unit_degree[0],
-                            is_coord_unit_degree[1],
-                            false)) {
-        have_points_on_the_same_line = false;
-        for (i = 0; i < 4; i ++) {
-            for (j = 0; j < 3; j ++) {
-                triangle_vertex_coord1_values[j] = bilinear_vertex_coord1_values[(i+j)%4];
-                triangle_vertex_coord2_values[j] = bilinear_vertex_coord2_values[(i+j)%4];                    
-            }
-            have_points_on_the_same_line |= are_three_points_on_the_same_line(triangle_vertex_coord1_values, triangle_vertex_coord2_values);
-            if (have_points_on_the_same_line)
-                break;        
-            triangle_vertex_coord1_values[0] = bilinear_vertex_coord1_values[i];
-            triangle_vertex_coord2_values[0] = bilinear_vertex_coord2_values[i];
-            triangle_vertex_coord1_values[1] = dst_cell_center_values[0];
-            triangle_vertex_coord2_values[1] = dst_cell_center_values[1];
-            triangle_vertex_coord1_values[2] = bilinear_vertex_coord1_values[(i+1)%4];
-            triangle_vertex_coord2_values[2] = bilinear_vertex_coord2_values[(i+1)%4];
-            have_points_on_the_same_line |= are_three_points_on_the_same_line(triangle_vertex_coord1_values, triangle_vertex_coord2_values);                
-            if (have_points_on_the_same_line)
-                break;
+    if (!is_point_in_2D_cell(dst_cell_center_values[0], 
+                             dst_cell_center_values[1],
+                             bilinear_vertex_coord1_values,
+                             bilinear_vertex_coord2_values,
+                             4,
+                             is_coord_unit_degree[0],
+                             is_coord_unit_degree[1],
+                             false))
+        return false;
+
+    for (i = 0; i < 4; i ++) {
+        for (j = 0; j < 3; j ++) {
+            triangle_vertex_coord1_values[j] = bilinear_vertex_coord1_values[(i+j)%4];
+            triangle_vertex_coord2_values[j] = bilinear_vertex_coord2_values[(i+j)%4];                    
         }
-        
-        if (!have_points_on_the_same_line) 
-            return true;
+        if (are_three_points_on_the_same_line(triangle_vertex_coord1_values, triangle_vertex_coord2_values))
+            return false;
+        triangle_vertex_coord1_values[0] = bilinear_vertex_coord1_values[i];
+        triangle_vertex_coord2_values[0] = bilinear_vertex_coord2_values[i];
+        triangle_vertex_coord1_values[1] = dst_cell_center_values[0];
+        triangle_vertex_coord2_values[1] = dst_cell_center_values[1];
+        triangle_vertex_coord1_values[2] = bilinear_vertex_coord1_values[(i+1)%4];
+        triangle_vertex_coord2_values[2] = bilinear_vertex_coord2_values[(i+1)%4];
+        if (are_three_points_on_the_same_line(triangle_vertex_coord1_values, triangle_vertex_coord2_values))
+            return false;
     }
 
+    return true;
+}
+
+
+bool Remap_operator_bilinear::get_near_optimal_bilinear_box_recursively(double **distances_of_src_points_in_each_quadrant,
+                                                                        long **indexes_of_src_points_in_each_quadrant,
+                                                                        const int *num_src_points_in_each_quadrant,
+                                                                        int *iter_num_src_points_in_each_quadrant,
+                                                                        const double* dst_cell_center_values,
+                                                                        long *index_of_selected_src_point_in_each_quadrant,
+                                                                        int recursion_index)
+{
+    int i, j;
+    double src_cell_center_values[2];
+    double distance_of_selected_src_point_in_each_quadrant[4];
+    int index_of_quadrant_id_for_distance_sorting[4];
+    int new_iter_num_src_points_in_each_quadrant[4];
+
+
+    for (i = 0; i < 4; i ++)
+        index_of_selected_src_point_in_each_quadrant[i] = indexes_of_src_points_in_each_quadrant[i][iter_num_src_points_in_each_quadrant[i]];
+    if (is_dst_point_in_bilinear_box(dst_cell_center_values, index_of_selected_src_point_in_each_quadrant))
+        return true;
+
     for (i = 0; i < 4; i ++) {
         index_of_selected_src_point_in_each_quadrant[i] = indexes_of_src_points_in_each_quadrant[i][iter_num_src_points_in_each_quadrant[i]];
         distance_of_selected_src_point_in_each_quadrant[i] = distances_of_src_points_in_each_quadrant[i][iter_num_src_points_in_each_quadrant[i]];
@@ -311,7 +330,6 @@ void Remap_operator_bilinear::compute_remap_weights_of_one_dst_cell(long dst_cel
     double dst_cell_center_values[2], src_cell_center_values[2];
     double current_threshold_distance, near_optimal_threshold_distance;
     long best_index_of_selected_src_point_in_each_quadrant[4];
-    double bilinear_box_vertex_coord1_values[4], bilinear_box_vertex_coord2_values[4];
     long bilinear_box_vertexes_src_cell_indexes[4];
     double wgt_ratio_u, wgt_ratio_v;
     double bilinear_wgt_values[4];
@@ -392,12 +410,6 @@ void Remap_operator_bilinear::compute_remap_weights_of_one_dst_cell(long dst_cel
         if (get_near_optimal_bilinear_box(dst_cell_center_values, 
                                           num_points_within_threshold_distance,
                                           best_index_of_selected_src_point_in_each_quadrant)) {
-            for (j = 0; j < 4; j ++) {
-                get_cell_center_coord_values_of_src_grid(best_index_of_selected_src_point_in_each_quadrant[j], src_cell_center_values);
-                bilinear_box_vertex_coord1_values[j] = src_cell_center_values[0];
-                bilinear_box_vertex_coord2_values[j] = src_cell_center_values[1];
-                bilinear_box_vertexes_src_cell_indexes[j] = best_index_of_selected_src_point_in_each_quadrant[j];
-            }
             find_bilinear_box = true;                   
             break;
         }
@@ -418,6 +430,8 @@ void Remap_operator_bilinear::compute_remap_weights_of_one_dst_cell(long dst_cel
                                                    enable_extrapolate);
     }
     else {
+        for (j = 0; j < 4; j ++)
+            bilinear_box_vertexes_src_cell_indexes[j] = best_index_of_selected_src_point_in_each_quadrant[j];
         solve_two_bilinear_ratios(bilinear_box_vertexes_src_cell_indexes, dst_cell_center_values, wgt_ratio_u, wgt_ratio_v);
         bilinear_wgt_values[0] = (1-wgt_ratio_u) * (1-wgt_ratio_v);
         bilinear_wgt_values[1] = wgt_ratio_u * (1-wgt_ratio_v);
@@ -30,6 +30,7 @@ class Remap_operator_bilinear: public Remap_operator_basis
         int compute_quadrant_of_src_point(double*, double*);
         bool get_near_optimal_bilinear_box(double*, int, long*);
         bool get_near_optimal_bilinear_box_recursively(double**, long**, const int*, int*, const double*, long*, int);
+        bool is_dst_point_in_bilinear_box(const double*, long*);
         bool are_three_points_on_the_same_line(double*, double*);
         void solve_two_bilinear_ratios(long*, double*, double&, double&);
         double compute_cross_product_of_counter_lines(double*, double*);
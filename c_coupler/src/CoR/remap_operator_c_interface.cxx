@@ -15,6 +15,12 @@
 #include "remap_utils_nearest_points.h"
 #include "grid_cell_search.h"
 #include <math.h>
+#include <string.h>
+#include <vector>
+
+
+#define SPHERE_POLYGON_LOCAL_CAPACITY      64
+#define SPHERE_POLYGON_EPS                 1.0e-14
 
 
 bool have_fetched_dst_grid_cell_coord_values;
@@ -89,6 +95,71 @@ void get_cell_center_coord_values_of_dst_grid(long cell_index, double *center_va
 }
 
 
+/* Index of a point on the Hilbert curve that fills a square of num_curve_points_per_dim*num_curve_points_per_dim points */
+static long compute_hilbert_curve_index(long num_curve_points_per_dim, long x, long y)
+{
+    long rx, ry, s, temp, index = 0;
+
+
+    for (s = num_curve_points_per_dim/2; s > 0; s /= 2) {
+        rx = (x & s) > 0? 1 : 0;
+        ry = (y & s) > 0? 1 : 0;
+        index += s * s * ((3*rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = num_curve_points_per_dim-1 - x;
+                y = num_curve_points_per_dim-1 - y;
+            }
+            temp = x;
+            x = y;
+            y = temp;
+        }
+    }
+
+    return index;
+}
+
+
+/* get_dst_grid_cells_in_space_filling_curve_order sorts the cells of the current dst grid along a Hilbert curve of their 
+    centers, so that successive dst cells are spatially close */
+void get_dst_grid_cells_in_space_filling_curve_order(long *dst_cell_indexes)
+{
+    Remap_operator_grid *grid = current_runtime_remap_operator_grid_dst;
+    long i, grid_size = grid->get_grid_size(), num_curve_points_per_dim = 65536, *curve_indexes;
+    double min_values[2], max_values[2], scales[2];
+    int j;
+
+
+    for (i = 0; i < grid_size; i ++)
+        dst_cell_indexes[i] = i;
+    if (grid->get_num_grid_dimensions() != 2 || grid_size <= 1)
+        return;
+
+    for (j = 0; j < 2; j ++) {
+        min_values[j] = 1.0e300;
+        max_values[j] = -1.0e300;
+        for (i = 0; i < grid_size; i ++) {
+            if (grid->get_center_coord_values()[j][i] == NULL_COORD_VALUE)
+                continue;
+            if (min_values[j] > grid->get_center_coord_values()[j][i])
+                min_values[j] = grid->get_center_coord_values()[j][i];
+            if (max_values[j] < grid->get_center_coord_values()[j][i])
+                max_values[j] = grid->get_center_coord_values()[j][i];
+        }
+        scales[j] = max_values[j] > min_values[j]? (num_curve_points_per_dim-1) / (max_values[j]-min_values[j]) : 0.0;
+    }
+
+    curve_indexes = new long [grid_size];
+    for (i = 0; i < grid_size; i ++)
+        if (grid->get_center_coord_values()[0][i] == NULL_COORD_VALUE || grid->get_center_coord_values()[1][i] == NULL_COORD_VALUE)
+            curve_indexes[i] = 0;
+        else curve_indexes[i] = compute_hilbert_curve_index(num_curve_points_per_dim, (long)((grid->get_center_coord_values()[0][i]-min_values[0])*scales[0]), 
+                                                       (long)((grid->get_center_coord_values()[1][i]-min_values[1])*scales[1]));
+    do_quick_sort(curve_indexes, dst_cell_indexes, 0, grid_size-1);
+    delete [] curve_indexes;
+}
+
+
 H2D_grid_cell_search_engine *get_current_grid2D_search_engine(bool is_src_grid)
 {
     if (is_src_grid) {
@@ -126,28 +197,43 @@ void get_cell_vertex_coord_values_of_grid(Remap_operator_grid *grid, long cell_i
 }
 
 
-void get_cell_vertex_coord_values_of_src_grid(long cell_index, int *num_vertex, double *vertex_values, bool check_consistency)
+static bool is_cell_close_to_sphere_pole(Remap_operator_grid *grid, long cell_index)
 {
-    int temp_num_vertex;
-    double temp_vertex_values[65536];
-    bool should_rotate;
+    int num_vertexes = grid->get_num_vertexes();
+    double **vertex_coord_values = grid->get_vertex_coord_values();
 
-    
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, cell_index >= 0 && cell_index < grid->get_grid_size(), "remap software error in is_cell_close_to_sphere_pole\n");
+    for (int i = 0; i < num_vertexes; i ++)
+        if (vertex_coord_values[0][num_vertexes*cell_index+i] != NULL_COORD_VALUE && fabs(vertex_coord_values[1][num_vertexes*cell_index+i]) > SPHERE_GRID_ROTATION_LAT_THRESHOLD)
+            return true;
+
+    return false;
+}
+
+
+/* The maximum number of vertexes of the common sub cell computed by compute_common_sub_cell_of_src_cell_and_dst_cell_2D:
+    each src edge contributes its end points and at most two intersections with each dst edge, and the dst vertexes in 
+    the src cell are added at last */
+int get_max_num_vertexes_of_common_sub_cell_2D()
+{
+    int num_vertexes_src = current_runtime_remap_operator_grid_src->get_num_vertexes();
+    int num_vertexes_dst = current_runtime_remap_operator_grid_dst->get_num_vertexes();
+
+
+    return num_vertexes_src*(2*num_vertexes_dst+2) + num_vertexes_dst;
+}
+
+
+void get_cell_vertex_coord_values_of_src_grid(long cell_index, int *num_vertex, double *vertex_values, bool check_consistency)
+{
     if (check_consistency) {
         if (using_rotated_grid_data)
             get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_src->get_rotated_remap_operator_grid(), cell_index, num_vertex, vertex_values, check_consistency);
         else get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_src, cell_index, num_vertex, vertex_values, check_consistency);
     }
     else {
-        get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_src, cell_index, &temp_num_vertex, temp_vertex_values, check_consistency);
-        EXECUTION_REPORT(REPORT_ERROR, -1, temp_num_vertex <= 65536/2, "Software error in get_cell_vertex_coord_values_of_src_grid: too big number of vertexes: %d", temp_num_vertex);
-        should_rotate = false;
-        for (int i = 0; i < temp_num_vertex; i ++)
-            if (fabs(temp_vertex_values[i*2+1]) > SPHERE_GRID_ROTATION_LAT_THRESHOLD) {
-                should_rotate = true;
-                break;
-            }
-        if (should_rotate)
+        if (is_cell_close_to_sphere_pole(current_runtime_remap_operator_grid_src, cell_index))
             get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_src->get_rotated_remap_operator_grid(), cell_index, num_vertex, vertex_values, check_consistency);
         else get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_src, cell_index, num_vertex, vertex_values, check_consistency);
     }
@@ -156,26 +242,13 @@ void get_cell_vertex_coord_values_of_src_grid(long cell_index, int *num_vertex,
 
 void get_cell_vertex_coord_values_of_dst_grid(long cell_index, int *num_vertex, double *vertex_values, bool check_consistency)
 {
-    int temp_num_vertex;
-    double temp_vertex_values[65536];
-    bool should_rotate;
-
-    
     if (check_consistency) {
         if (using_rotated_grid_data)
             get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_dst->get_rotated_remap_operator_grid(), cell_index, num_vertex, vertex_values, check_consistency);
         else get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_dst, cell_index, num_vertex, vertex_values, check_consistency);
     }
     else {
-        get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_dst, cell_index, &temp_num_vertex, temp_vertex_values, check_consistency);
-        EXECUTION_REPORT(REPORT_ERROR, -1, temp_num_vertex <= 65536/2, "Software error in get_cell_vertex_coord_values_of_dst_grid: too big number of vertexes: %d", temp_num_vertex);        
-        should_rotate = false;
-        for (int i = 0; i < temp_num_vertex; i ++)
-            if (fabs(temp_vertex_values[i*2+1]) > SPHERE_GRID_ROTATION_LAT_THRESHOLD) {
-                should_rotate = true;
-                break;
-            }
-        if (should_rotate)
+        if (is_cell_close_to_sphere_pole(current_runtime_remap_operator_grid_dst, cell_index))
             get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_dst->get_rotated_remap_operator_grid(), cell_index, num_vertex, vertex_values, check_consistency);
         else get_cell_vertex_coord_values_of_grid(current_runtime_remap_operator_grid_dst, cell_index, num_vertex, vertex_values, check_consistency);
     }
@@ -1048,3 +1121,232 @@ void compute_common_sub_cell_of_src_cell_and_dst_cell_2D(long cell_index_src,
     */
 }
 
+
+/* Vertexes (3-D Cartesian coordinates on the unit sphere) of a polygon used by the clipping overlap kernel. The buffer 
+    stays on the stack for common cells and only moves to the heap for cells with a lot of vertexes */
+class Sphere_polygon_buffer
+{
+    private:
+        double local_points[3*SPHERE_POLYGON_LOCAL_CAPACITY];
+        std::vector<double> heap_points;
+
+    public:
+        double *points;
+        int num_points;
+        int capacity;
+
+        Sphere_polygon_buffer() { points = local_points; num_points = 0; capacity = SPHERE_POLYGON_LOCAL_CAPACITY; }
+        void reserve(int);
+};
+
+
+void Sphere_polygon_buffer::reserve(int new_capacity)
+{
+    if (new_capacity <= capacity)
+        return;
+
+    heap_points.resize(3*new_capacity);
+    if (points == local_points)
+        memcpy(heap_points.data(), local_points, 3*num_points*sizeof(double));
+    points = heap_points.data();
+    capacity = new_capacity;
+}
+
+
+static inline void compute_cross_product_of_3D_vectors(const double *vector1, const double *vector2, double *result)
+{
+    result[0] = vector1[1]*vector2[2] - vector1[2]*vector2[1];
+    result[1] = vector1[2]*vector2[0] - vector1[0]*vector2[2];
+    result[2] = vector1[0]*vector2[1] - vector1[1]*vector2[0];
+}
+
+
+static inline double compute_triple_product_of_3D_vectors(const double *vector1, const double *vector2, const double *vector3)
+{
+    double cross_product[3];
+
+
+    compute_cross_product_of_3D_vectors(vector2, vector3, cross_product);
+    return vector1[0]*cross_product[0] + vector1[1]*cross_product[1] + vector1[2]*cross_product[2];
+}
+
+
+/* The input order of the vertexes is kept, so that concave cells keep their shape, and is only reversed when the 
+    signed area around the centroid shows that the polygon is clockwise (viewed from outside the sphere). After that, 
+    the left side of each edge is the inside of the polygon */
+static void orient_sphere_polygon_counterclockwise(Sphere_polygon_buffer &polygon)
+{
+    double centroid[3] = {0, 0, 0}, signed_area = 0, point[3];
+    int i, k;
+
+
+    for (i = 0; i < polygon.num_points; i ++)
+        for (k = 0; k < 3; k ++)
+            centroid[k] += polygon.points[3*i+k];
+    for (i = 0; i < polygon.num_points; i ++)
+        signed_area += compute_triple_product_of_3D_vectors(centroid, polygon.points+3*i, polygon.points+3*((i+1)%polygon.num_points));
+    if (signed_area >= 0)
+        return;
+
+    for (i = 0; i < polygon.num_points/2; i ++)
+        for (k = 0; k < 3; k ++) {
+            point[k] = polygon.points[3*i+k];
+            polygon.points[3*i+k] = polygon.points[3*(polygon.num_points-1-i)+k];
+            polygon.points[3*(polygon.num_points-1-i)+k] = point[k];
+        }
+}
+
+
+static void get_cell_polygon_on_sphere(Remap_operator_grid *grid, long cell_index, Sphere_polygon_buffer &polygon)
+{
+    int i, j, num_vertexes = grid->get_num_vertexes();
+    double *point, *last_point;
+
+
+    polygon.num_points = 0;
+    polygon.reserve(num_vertexes);
+    for (i = 0; i < num_vertexes; i ++) {
+        if (grid->get_vertex_coord_values()[0][num_vertexes*cell_index+i] == NULL_COORD_VALUE)
+            continue;
+        point = polygon.points + 3*polygon.num_points;
+        get_3D_cartesian_coord_of_sphere_coord(point[0], point[1], point[2], grid->get_vertex_coord_values()[0][num_vertexes*cell_index+i], grid->get_vertex_coord_values()[1][num_vertexes*cell_index+i]);
+        for (j = 0; j < polygon.num_points; j ++) {
+            last_point = polygon.points + 3*j;
+            if (fabs(point[0]-last_point[0]) + fabs(point[1]-last_point[1]) + fabs(point[2]-last_point[2]) < SPHERE_POLYGON_EPS)
+                break;
+        }
+        if (j == polygon.num_points)
+            polygon.num_points ++;
+    }
+    orient_sphere_polygon_counterclockwise(polygon);
+}
+
+
+static bool is_sphere_polygon_convex(const Sphere_polygon_buffer &polygon)
+{
+    int i, num_points = polygon.num_points;
+
+
+    for (i = 0; i < num_points; i ++)
+        if (compute_triple_product_of_3D_vectors(polygon.points+3*((i+num_points-1)%num_points), polygon.points+3*i, polygon.points+3*((i+1)%num_points)) < -SPHERE_POLYGON_EPS)
+            return false;
+
+    return true;
+}
+
+
+/* One Sutherland-Hodgman step: keeps the part of the subject polygon on the left side of the great circle through 
+    clip_point1 and clip_point2. The plane of a great circle passes the center of the sphere, so its intersection with a 
+    chord of the subject polygon projected back to the sphere is the intersection with the great arc */
+static void clip_sphere_polygon_by_great_circle(const Sphere_polygon_buffer &subject, const double *clip_point1, const double *clip_point2, Sphere_polygon_buffer &result)
+{
+    double normal[3], norm, distance_current, distance_next, t, *point;
+    const double *current_point, *next_point;
+    int i, k;
+
+
+    result.num_points = 0;
+    result.reserve(2*subject.num_points);
+    compute_cross_product_of_3D_vectors(clip_point1, clip_point2, normal);
+    norm = sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+    if (norm < SPHERE_POLYGON_EPS) {
+        memcpy(result.points, subject.points, 3*subject.num_points*sizeof(double));
+        result.num_points = subject.num_points;
+        return;
+    }
+    for (k = 0; k < 3; k ++)
+        normal[k] /= norm;
+
+    for (i = 0; i < subject.num_points; i ++) {
+        current_point = subject.points + 3*i;
+        next_point = subject.points + 3*((i+1)%subject.num_points);
+        distance_current = normal[0]*current_point[0] + normal[1]*current_point[1] + normal[2]*current_point[2];
+        distance_next = normal[0]*next_point[0] + normal[1]*next_point[1] + normal[2]*next_point[2];
+        if (distance_current >= -SPHERE_POLYGON_EPS) {
+            memcpy(result.points+3*result.num_points, current_point, 3*sizeof(double));
+            result.num_points ++;
+        }
+        if ((distance_current >= -SPHERE_POLYGON_EPS) != (distance_next >= -SPHERE_POLYGON_EPS) && fabs(distance_current-distance_next) > SPHERE_POLYGON_EPS) {
+            t = distance_current / (distance_current-distance_next);
+            point = result.points + 3*result.num_points;
+            for (k = 0; k < 3; k ++)
+                point[k] = current_point[k] + t*(next_point[k]-current_point[k]);
+            norm = sqrt(point[0]*point[0] + point[1]*point[1] + point[2]*point[2]);
+            if (norm < SPHERE_POLYGON_EPS)
+                continue;
+            for (k = 0; k < 3; k ++)
+                point[k] /= norm;
+            result.num_points ++;
+        }
+    }
+}
+
+
+/* The area is the sum of the signed spherical excesses of the fan triangles, computed with the formula of 
+    Van Oosterom and Strackee, which keeps its accuracy for tiny sub cells */
+static double compute_area_of_sphere_polygon(const Sphere_polygon_buffer &polygon)
+{
+    const double *point0 = polygon.points, *point1, *point2;
+    double area = 0, denominator;
+
+
+    for (int i = 1; i+1 < polygon.num_points; i ++) {
+        point1 = polygon.points + 3*i;
+        point2 = polygon.points + 3*(i+1);
+        denominator = 1 + (point0[0]*point1[0]+point0[1]*point1[1]+point0[2]*point1[2]) + (point1[0]*point2[0]+point1[1]*point2[1]+point1[2]*point2[2]) + (point2[0]*point0[0]+point2[1]*point0[1]+point2[2]*point0[2]);
+        area += 2*atan2(compute_triple_product_of_3D_vectors(point0, point1, point2), denominator);
+    }
+
+    return area > 0? area : 0;
+}
+
+
+static std::vector<double> concave_sub_cell_vertexes_lons, concave_sub_cell_vertexes_lats;
+
+
+/* compute_overlap_area_of_src_cell_and_dst_cell_2D computes the area of the common part of a src cell and a dst cell by
+    clipping one polygon with the great circles of the edges of the other one in 3-D Cartesian space. The clipping 
+    polygon must be convex while the clipped one can be concave; when both cells are concave, the great-arc kernel 
+    compute_common_sub_cell_of_src_cell_and_dst_cell_2D is used */
+double compute_overlap_area_of_src_cell_and_dst_cell_2D(long cell_index_src, long cell_index_dst)
+{
+    Sphere_polygon_buffer polygon_src, polygon_dst, clipped_polygons[2];
+    Sphere_polygon_buffer *subject_polygon, *clip_polygon, *input_polygon, *output_polygon;
+    Remap_operator_grid *grid_src, *grid_dst;
+    int i, num_sub_cell_vertexes;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, have_fetched_dst_grid_cell_coord_values, "remap software error1 in compute_overlap_area_of_src_cell_and_dst_cell_2D\n");
+    EXECUTION_REPORT(REPORT_ERROR, -1, current_runtime_remap_operator->get_num_dimensions() == 2, "remap software error2 in compute_overlap_area_of_src_cell_and_dst_cell_2D\n");
+
+    grid_src = using_rotated_grid_data? current_runtime_remap_operator_grid_src->get_rotated_remap_operator_grid() : current_runtime_remap_operator_grid_src;
+    grid_dst = using_rotated_grid_data? current_runtime_remap_operator_grid_dst->get_rotated_remap_operator_grid() : current_runtime_remap_operator_grid_dst;
+    get_cell_polygon_on_sphere(grid_src, cell_index_src, polygon_src);
+    get_cell_polygon_on_sphere(grid_dst, cell_index_dst, polygon_dst);
+    if (polygon_src.num_points < 3 || polygon_dst.num_points < 3)
+        return 0;
+
+    subject_polygon = &polygon_src;
+    clip_polygon = &polygon_dst;
+    if (!is_sphere_polygon_convex(polygon_dst)) {
+        if (!is_sphere_polygon_convex(polygon_src)) {
+            if (concave_sub_cell_vertexes_lons.size() < get_max_num_vertexes_of_common_sub_cell_2D()) {
+                concave_sub_cell_vertexes_lons.resize(get_max_num_vertexes_of_common_sub_cell_2D());
+                concave_sub_cell_vertexes_lats.resize(get_max_num_vertexes_of_common_sub_cell_2D());
+            }
+            compute_common_sub_cell_of_src_cell_and_dst_cell_2D(cell_index_src, cell_index_dst, num_sub_cell_vertexes, concave_sub_cell_vertexes_lons.data(), concave_sub_cell_vertexes_lats.data());
+            return num_sub_cell_vertexes > 0? compute_area_of_sphere_cell(num_sub_cell_vertexes, concave_sub_cell_vertexes_lons.data(), concave_sub_cell_vertexes_lats.data()) : 0;
+        }
+        subject_polygon = &polygon_dst;
+        clip_polygon = &polygon_src;
+    }
+
+    input_polygon = subject_polygon;
+    for (i = 0; i < clip_polygon->num_points && input_polygon->num_points > 0; i ++) {
+        output_polygon = &clipped_polygons[i%2];
+        clip_sphere_polygon_by_great_circle(*input_polygon, clip_polygon->points+3*i, clip_polygon->points+3*((i+1)%clip_polygon->num_points), *output_polygon);
+        input_polygon = output_polygon;
+    }
+
+    return compute_area_of_sphere_polygon(*input_polygon);
+}
@@ -34,13 +34,16 @@ extern bool have_overlapped_src_cells_for_dst_cell(long, bool);
 extern void compute_intersect_points_of_two_great_arcs_of_sphere_grid(double, double, double, double, double, double,
                                                                        double, double, int&, double*, double*);
 extern void compute_common_sub_cell_of_src_cell_and_dst_cell_2D(long, long, int&, double*, double*);
+extern int get_max_num_vertexes_of_common_sub_cell_2D();
 extern double compute_area_of_sphere_cell(int, double*, double*);
+extern double compute_overlap_area_of_src_cell_and_dst_cell_2D(long, long);
 extern void compute_cell_bounding_box(int, int, double*, double*);
 extern void sort_vertexes_of_sphere_cell(int, double*, double*);
 extern bool are_the_same_sphere_points(double, double, double, double);
 
 extern long get_size_of_src_grid();
 extern long get_size_of_dst_grid();
+extern void get_dst_grid_cells_in_space_filling_curve_order(long*);
 
 extern H2D_grid_cell_search_engine *get_current_grid2D_search_engine(bool);
 
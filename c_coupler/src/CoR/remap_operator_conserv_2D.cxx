@@ -18,38 +18,72 @@ void Remap_operator_conserv_2D::set_parameter(const char *parameter_name, const
                  "the parameter of remap operator object \"%s\" must be set before using it to build remap strategy\n",
                  object_name);
     
-    EXECUTION_REPORT(REPORT_ERROR, -1, false, 
-                      "\"%s\" is a illegal parameter of remap operator \"%s\"\n",
-                      parameter_name,
-                      operator_name);
+    if (words_are_the_same(parameter_name, "overlap_algorithm")) {
+        if (words_are_the_same(parameter_value, "polygon_clipping"))
+            overlap_by_polygon_clipping = true;
+        else if (words_are_the_same(parameter_value, "great_arc"))
+            overlap_by_polygon_clipping = false;
+        else EXECUTION_REPORT(REPORT_ERROR, -1, false, "The parameter value must be \"polygon_clipping\" or \"great_arc\"\n");
+    }
+    else EXECUTION_REPORT(REPORT_ERROR, -1, false, 
+                          "\"%s\" is a illegal parameter of remap operator \"%s\"\n",
+                          parameter_name,
+                          operator_name);
 }
 
 
 int Remap_operator_conserv_2D::check_parameter(const char *parameter_name, const char *parameter_value, char *error_string)
 {
-    return 0;
+    int check_result = 0;
+    if (words_are_the_same(parameter_name, "overlap_algorithm")) {
+        check_result = 1;
+        if (words_are_the_same(parameter_value, "polygon_clipping") || words_are_the_same(parameter_value, "great_arc"))
+            check_result = 3;
+        else sprintf(error_string, "The parameter value must be \"polygon_clipping\" or \"great_arc\"");
+    }
+    
+    return check_result;
+}
+
+
+bool Remap_operator_conserv_2D::compute_overlap_area_by_great_arcs(long cell_index_src, long cell_index_dst, double &area)
+{
+    int num_common_sub_cell_vertexes;
+
+
+    if (common_sub_cell_vertexes_lons.size() < get_max_num_vertexes_of_common_sub_cell_2D()) {
+        common_sub_cell_vertexes_lons.resize(get_max_num_vertexes_of_common_sub_cell_2D());
+        common_sub_cell_vertexes_lats.resize(get_max_num_vertexes_of_common_sub_cell_2D());
+    }
+    compute_common_sub_cell_of_src_cell_and_dst_cell_2D(cell_index_src, cell_index_dst, num_common_sub_cell_vertexes, 
+                                                        common_sub_cell_vertexes_lons.data(), common_sub_cell_vertexes_lats.data());
+    if (num_common_sub_cell_vertexes == 0)
+        return false;
+    area = compute_area_of_sphere_cell(num_common_sub_cell_vertexes, common_sub_cell_vertexes_lons.data(), common_sub_cell_vertexes_lats.data());
+
+    return true;
 }
 
 
 void Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell(long cell_index_dst)
 {
-    double center_coord_values_dst[2], vertex_coord_values_dst[65536];
+    double center_coord_values_dst[2];
     int num_vertexes_dst, num_grid_dimensions_dst, i;
     long cell_index_src, *overlapping_src_cells_indexes;
-    double common_sub_cell_vertexes_lons[65536], common_sub_cell_vertexes_lats[65536];
-    double common_sub_cell_area[65536], weight_values[65536], sum_area;
-    int num_overlapping_src_cells, num_common_sub_cell_vertexes, num_weights;
+    double area, sum_area;
+    int num_overlapping_src_cells, num_weights;
 
 
-    get_cell_center_coord_values_of_dst_grid(cell_index_dst, center_coord_values_dst);
-    get_cell_vertex_coord_values_of_dst_grid(cell_index_dst, &num_vertexes_dst, vertex_coord_values_dst, false);    
-    EXECUTION_REPORT(REPORT_ERROR, -1, num_vertexes_dst <= 65536/2, "Software error in Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell: too big num_vertexes_dst: %d", num_vertexes_dst);
     num_grid_dimensions_dst = current_runtime_remap_operator_grid_src->get_num_grid_dimensions();
+    if (vertex_coord_values_dst.size() < current_runtime_remap_operator_grid_dst->get_num_vertexes()*num_grid_dimensions_dst)
+        vertex_coord_values_dst.resize(current_runtime_remap_operator_grid_dst->get_num_vertexes()*num_grid_dimensions_dst);
+    get_cell_center_coord_values_of_dst_grid(cell_index_dst, center_coord_values_dst);
+    get_cell_vertex_coord_values_of_dst_grid(cell_index_dst, &num_vertexes_dst, vertex_coord_values_dst.data(), false);    
 
     for (i = 0; i < num_vertexes_dst; i ++) {
         if (vertex_coord_values_dst[i*num_grid_dimensions_dst] == NULL_COORD_VALUE)
             continue;
-        search_cell_in_src_grid(vertex_coord_values_dst+i*num_grid_dimensions_dst, &cell_index_src, true);
+        search_cell_in_src_grid(vertex_coord_values_dst.data()+i*num_grid_dimensions_dst, &cell_index_src, true);
         if (cell_index_src != -1)
             break;
     }    
@@ -62,16 +96,22 @@ void Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell(long cell_
     if (num_overlapping_src_cells == 0)
         return;
 
+    if (common_sub_cell_area.size() < num_overlapping_src_cells) {
+        common_sub_cell_area.resize(num_overlapping_src_cells);
+        weight_values.resize(num_overlapping_src_cells);
+    }
     for (i = 0, sum_area = 0, num_weights = 0; i < num_overlapping_src_cells; i ++) {
-        compute_common_sub_cell_of_src_cell_and_dst_cell_2D(overlapping_src_cells_indexes[i], cell_index_dst, num_common_sub_cell_vertexes, 
-                                                            common_sub_cell_vertexes_lons, common_sub_cell_vertexes_lats);
-        EXECUTION_REPORT(REPORT_ERROR, -1, num_common_sub_cell_vertexes <= 65536/2, "Software error in Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell: too big num_common_sub_cell_vertexes: %d", num_common_sub_cell_vertexes);
-        if (num_common_sub_cell_vertexes > 0) {
-            common_sub_cell_area[num_weights] = compute_area_of_sphere_cell(num_common_sub_cell_vertexes, common_sub_cell_vertexes_lons, common_sub_cell_vertexes_lats);
-            overlapping_src_cells_indexes[num_weights] = overlapping_src_cells_indexes[i];
-            sum_area += common_sub_cell_area[num_weights];
-            num_weights ++;
+        if (overlap_by_polygon_clipping) {
+            area = compute_overlap_area_of_src_cell_and_dst_cell_2D(overlapping_src_cells_indexes[i], cell_index_dst);
+            if (area <= 0)
+                continue;
         }
+        else if (!compute_overlap_area_by_great_arcs(overlapping_src_cells_indexes[i], cell_index_dst, area))
+            continue;
+        common_sub_cell_area[num_weights] = area;
+        overlapping_src_cells_indexes[num_weights] = overlapping_src_cells_indexes[i];
+        sum_area += common_sub_cell_area[num_weights];
+        num_weights ++;
     }
 
     if (num_weights > 0)
@@ -80,7 +120,7 @@ void Remap_operator_conserv_2D::compute_remap_weights_of_one_dst_cell(long cell_
         weight_values[i] = common_sub_cell_area[i]/sum_area;
     }
 
-    add_remap_weights_to_sparse_matrix(overlapping_src_cells_indexes, cell_index_dst, weight_values, num_weights, 0, true);
+    add_remap_weights_to_sparse_matrix(overlapping_src_cells_indexes, cell_index_dst, weight_values.data(), num_weights, 0, true);
 }
 
 
@@ -118,6 +158,7 @@ Remap_operator_conserv_2D::Remap_operator_conserv_2D(const char *object_name, in
                                                               remap_grids)
 {
     num_order = 1;
+    overlap_by_polygon_clipping = false;
     remap_weights_groups.push_back(new Remap_weight_sparse_matrix(this));
 }
 
@@ -139,6 +180,7 @@ Remap_operator_basis *Remap_operator_conserv_2D::duplicate_remap_operator(bool f
     Remap_operator_conserv_2D *duplicated_remap_operator = new Remap_operator_conserv_2D();
     copy_remap_operator_basic_data(duplicated_remap_operator, fully_copy);
     duplicated_remap_operator->num_order = num_order;
+    duplicated_remap_operator->overlap_by_polygon_clipping = overlap_by_polygon_clipping;
     return duplicated_remap_operator;
 }
 
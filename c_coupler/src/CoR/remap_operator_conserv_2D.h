@@ -17,11 +17,18 @@ class Remap_operator_conserv_2D: public Remap_operator_basis
 {
     private:
         int num_order;
+        bool overlap_by_polygon_clipping;
+        std::vector<double> common_sub_cell_area;
+        std::vector<double> weight_values;
+        std::vector<double> vertex_coord_values_dst;
+        std::vector<double> common_sub_cell_vertexes_lons;
+        std::vector<double> common_sub_cell_vertexes_lats;
+        bool compute_overlap_area_by_great_arcs(long, long, double&);
         void compute_remap_weights_of_one_dst_cell(long);
 
     public:
         Remap_operator_conserv_2D(const char*, int, Remap_grid_class **);
-        Remap_operator_conserv_2D() {}
+        Remap_operator_conserv_2D() { overlap_by_polygon_clipping = false; }
         ~Remap_operator_conserv_2D() {}
         void set_parameter(const char *, const char *);
         int check_parameter(const char *, const char *, char*);
@@ -55,6 +55,33 @@ double calculate_distance_of_two_points_2D(double point1_coord1_value,
 }
 
 
+/* The chord distance between two points on the unit sphere is 2*sin(arc/2), which increases with the great-arc distance
+    so that the nearest points can be ranked and filtered with chord distances */
+double convert_arc_distance_to_squared_chord_distance(double arc_distance)
+{
+    double half_chord;
+
+
+    if (arc_distance >= PI)
+        return 4.0;
+    half_chord = sin(arc_distance/2);
+    return 4*half_chord*half_chord;
+}
+
+
+/* Only the distances of the finally selected points are converted back to great-arc distances */
+void convert_squared_chord_distances_to_arc_distances(int num_points, double *distances)
+{
+    double half_chord;
+
+
+    for (int i = 0; i < num_points; i ++) {
+        half_chord = sqrt(distances[i]) / 2;
+        distances[i] = 2*asin(half_chord < 1.0? half_chord : 1.0);
+    }
+}
+
+
 void compute_dist_remap_weights_of_one_dst_cell(long dst_cell_index,
                                                 int num_nearest_points,
                                                 double num_power,
@@ -13,6 +13,15 @@
 
 extern void compute_dist_remap_weights_of_one_dst_cell(long, int, double, double*, double*, long*, double*, bool, bool);
 extern double calculate_distance_of_two_points_2D(double, double, double, double, bool);
+extern double convert_arc_distance_to_squared_chord_distance(double);
+extern void convert_squared_chord_distances_to_arc_distances(int, double*);
+
+
+inline double compute_squared_chord_distance(const double *unit_vector1, const double *unit_vector2)
+{
+    double diff_x = unit_vector1[0] - unit_vector2[0], diff_y = unit_vector1[1] - unit_vector2[1], diff_z = unit_vector1[2] - unit_vector2[2];
+    return diff_x*diff_x + diff_y*diff_y + diff_z*diff_z;
+}
 
 
 #endif
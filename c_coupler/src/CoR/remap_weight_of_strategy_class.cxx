@@ -229,25 +229,42 @@ Remap_weight_of_operator_class::~Remap_weight_of_operator_class()
 void Remap_weight_of_operator_class::do_remap(int comp_id, Remap_grid_data_class *field_data_src, Remap_grid_data_class *field_data_dst)
 {
 
-    double *data_value_src, *data_value_dst;
+    double *data_value_src, *data_value_dst, *data_buf_src, *data_buf_dst;
     int i, j, k;
     long remap_beg_iter, remap_end_iter;
-    long field_array_offset;
+    long field_array_offset_src, field_array_offset_dst;
     long field_data_size_src, field_data_size_dst;
+    long operator_stride_src, operator_stride_dst, operator_size_src, operator_size_dst;
 
     
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_data_src->get_coord_value_grid()->is_similar_grid_with(field_data_grid_src), "C-Coupler error1 in do_remap of Remap_weight_of_operator_class");
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_data_dst->get_coord_value_grid()->is_similar_grid_with(field_data_grid_dst), "C-Coupler error2 in do_remap of Remap_weight_of_operator_class");
 
-    if (comp_id != -1)          
-        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
-    field_data_src->interchange_grid_data(field_data_grid_src);
-    field_data_dst->interchange_grid_data(field_data_grid_dst);
-    if (comp_id != -1)          
-        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
+    /* When the operator grids are adjacent in the current layouts of the field data, the columns are accessed in place 
+       as strided views, which avoids transposing the whole field data before and after remapping */
+    if (!field_data_src->get_strided_view_of_grid_data(field_data_grid_src, operator_grid_src, operator_stride_src, column_offsets_src) ||
+        !field_data_dst->get_strided_view_of_grid_data(field_data_grid_dst, operator_grid_dst, operator_stride_dst, column_offsets_dst) ||
+        column_offsets_src.size() != column_offsets_dst.size()) {
+        if (comp_id != -1)          
+            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
+        field_data_src->interchange_grid_data(field_data_grid_src);
+        field_data_dst->interchange_grid_data(field_data_grid_dst);
+        if (comp_id != -1)          
+            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
+        operator_stride_src = 1;
+        operator_stride_dst = 1;
+        column_offsets_src.resize(field_data_grid_src->get_grid_size()/operator_grid_src->get_grid_size());
+        column_offsets_dst.resize(column_offsets_src.size());
+        for (j = 0; j < column_offsets_src.size(); j ++) {
+            column_offsets_src[j] = j*operator_grid_src->get_grid_size();
+            column_offsets_dst[j] = j*operator_grid_dst->get_grid_size();
+        }
+    }
 
     field_data_size_src = field_data_src->get_grid_data_field()->read_data_size;
     field_data_size_dst = field_data_dst->get_grid_data_field()->read_data_size;
+    data_buf_src = (double*) field_data_src->get_grid_data_field()->data_buf;
+    data_buf_dst = (double*) field_data_dst->get_grid_data_field()->data_buf;
 
     EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !is_remap_weight_empty(), "Software error in Remap_weight_of_operator_class::do_remap: empty remap weights");
     
@@ -258,23 +275,92 @@ void Remap_weight_of_operator_class::do_remap(int comp_id, Remap_grid_data_class
         else if (i+1 < remap_weights_of_operator_instances.size())
                 remap_end_iter = remap_weights_of_operator_instances[i+1]->remap_beg_iter;
         else remap_end_iter = field_data_grid_src->get_grid_size()/operator_grid_src->get_grid_size();
+        operator_size_src = remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size();
+        operator_size_dst = remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size();
+        if (operator_stride_src != 1 && column_buffer_src.size() < operator_size_src)
+            column_buffer_src.resize(operator_size_src);
+        if (operator_stride_dst != 1 && column_buffer_dst.size() < operator_size_dst)
+            column_buffer_dst.resize(operator_size_dst);
         for (j = remap_beg_iter; j < remap_end_iter; j ++) {
-            field_array_offset = j;
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, j >= 0 && j < column_offsets_src.size(), "remap software error6 in do_remap of Remap_weight_of_strategy_class");
+            field_array_offset_src = column_offsets_src[j];
+            field_array_offset_dst = column_offsets_dst[j];
             if (report_error_enabled) {
-                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && (field_array_offset+1)*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size() <= field_data_size_src,
+                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset_src >= 0 && field_array_offset_src+(operator_size_src-1)*operator_stride_src < field_data_size_src,
                                  "remap software error4 in do_remap of Remap_weight_of_strategy_class");
-                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset >= 0 && (field_array_offset+1)*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size() <= field_data_size_dst,
+                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_array_offset_dst >= 0 && field_array_offset_dst+(operator_size_dst-1)*operator_stride_dst < field_data_size_dst,
                                   "remap software error5 in do_remap of Remap_weight_of_strategy_class");
             }    
-            data_value_src = ((double*) field_data_src->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_size();
-            data_value_dst = ((double*) field_data_dst->get_grid_data_field()->data_buf) + field_array_offset*remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size();
+            data_value_src = data_buf_src + field_array_offset_src;
+            data_value_dst = data_buf_dst + field_array_offset_dst;
+            /* The remap kernels work on contiguous columns: a strided column is gathered into a reused buffer, and the 
+               dst column is gathered too because the cells that are not remapped keep their values */
+            if (operator_stride_src != 1) {
+                for (k = 0; k < operator_size_src; k ++)
+                    column_buffer_src[k] = data_value_src[k*operator_stride_src];
+                data_value_src = column_buffer_src.data();
+            }
+            if (operator_stride_dst != 1) {
+                for (k = 0; k < operator_size_dst; k ++)
+                    column_buffer_dst[k] = data_value_dst[k*operator_stride_dst];
+                data_value_dst = column_buffer_dst.data();
+            }
             EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, remap_weights_of_operator_instances[i]->duplicated_remap_operator != NULL, "C-Coupler error3 in do_remap of Remap_weight_of_operator_class %s", remap_weights_of_operator_instances[i]->get_operator_grid_src()->get_grid_name());
-            remap_weights_of_operator_instances[i]->duplicated_remap_operator->do_remap_values_caculation(data_value_src, data_value_dst, remap_weights_of_operator_instances[i]->get_operator_grid_dst()->get_grid_size());
+            remap_weights_of_operator_instances[i]->duplicated_remap_operator->do_remap_values_caculation(data_value_src, data_value_dst, operator_size_dst);
+            if (operator_stride_dst != 1)
+                for (k = 0; k < operator_size_dst; k ++)
+                    data_buf_dst[field_array_offset_dst+k*operator_stride_dst] = column_buffer_dst[k];
         }
     }
 }
 
 
+bool Remap_weight_of_operator_class::is_single_column_H2D_remapping()
+{
+    Remap_operator_basis *remap_operator;
+
+
+    if (empty_remap_weight || remap_weights_of_operator_instances.size() != 1 || !operator_grid_src->get_is_sphere_grid())
+        return false;
+    if (field_data_grid_src->get_grid_size() != operator_grid_src->get_grid_size() || field_data_grid_dst->get_grid_size() != operator_grid_dst->get_grid_size())
+        return false;
+    remap_operator = remap_weights_of_operator_instances[0]->duplicated_remap_operator;
+
+    return remap_operator != NULL && remap_operator->get_num_remap_weights_groups() == 1;
+}
+
+
+/* Composes the H2D remapping of this object and then of next_remap_weights into one sparse matrix, which is kept 
+    only when it has at most fill_in_ratio times the weights of the two sparse matrices */
+Remap_weight_of_operator_class *Remap_weight_of_operator_class::compose_with_next_remap_weights(Remap_weight_of_operator_class *next_remap_weights, long fill_in_ratio)
+{
+    Remap_operator_basis *previous_remap_operator, *next_remap_operator, *composed_remap_operator;
+    Remap_weight_sparse_matrix *composed_sparse_matrix;
+    Remap_weight_of_operator_class *composed_remap_weights;
+
+
+    if (!this->is_single_column_H2D_remapping() || !next_remap_weights->is_single_column_H2D_remapping() || this->field_data_grid_dst->get_grid_size() != next_remap_weights->field_data_grid_src->get_grid_size())
+        return NULL;
+
+    previous_remap_operator = this->remap_weights_of_operator_instances[0]->duplicated_remap_operator;
+    next_remap_operator = next_remap_weights->remap_weights_of_operator_instances[0]->duplicated_remap_operator;
+    composed_remap_operator = next_remap_operator->duplicate_remap_operator(false);
+    composed_remap_operator->set_src_grid(previous_remap_operator->get_src_grid());
+    composed_sparse_matrix = next_remap_operator->get_remap_weights_group(0)->compose_with_previous_sparse_matrix(previous_remap_operator->get_remap_weights_group(0), composed_remap_operator, 
+                             fill_in_ratio*(previous_remap_operator->get_remap_weights_group(0)->get_num_weights()+next_remap_operator->get_remap_weights_group(0)->get_num_weights()));
+    if (composed_sparse_matrix == NULL) {
+        delete composed_remap_operator;
+        return NULL;
+    }
+    composed_remap_operator->add_weight_sparse_matrix(composed_sparse_matrix);
+
+    composed_remap_weights = new Remap_weight_of_operator_class(this->field_data_grid_src, next_remap_weights->field_data_grid_dst, next_remap_weights->original_remap_operator, this->operator_grid_src, next_remap_weights->operator_grid_dst);
+    composed_remap_weights->add_remap_weight_of_operator_instance(new Remap_weight_of_operator_instance_class(this->field_data_grid_src, next_remap_weights->field_data_grid_dst, 0, next_remap_weights->original_remap_operator, composed_remap_operator));
+
+    return composed_remap_weights;
+}
+
+
 void Remap_weight_of_operator_class::add_remap_weight_of_operator_instance(Remap_weight_of_operator_instance_class *operator_instance)
 {
     remap_weights_of_operator_instances.push_back(operator_instance);
@@ -364,9 +450,14 @@ void Remap_weight_of_operator_class::renew_vertical_remap_weights(Remap_grid_cla
 void Remap_weight_of_operator_class::write_overall_remapping_weights(int comp_id, int src_original_grid_id, int dst_original_grid_id)
 {
 	char default_wgt_file_name[NAME_STR_SIZE], full_default_wgt_file_name[NAME_STR_SIZE*2], src_H2D_sub_grid_name[NAME_STR_SIZE], dst_H2D_sub_grid_name[NAME_STR_SIZE];
-	Remap_operator_basis *overall_remap_operator;
+	Remap_operator_basis *overall_remap_operator, *local_remap_operator;
+	Remap_weight_sparse_matrix *owned_sparse_matrix;
 	Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
 	Original_grid_info *src_original_grid = NULL, *dst_original_grid = NULL;
+	IO_netcdf *io_netcdf;
+	long weights_offset, num_overall_weights, slab_info[2], max_slab_size = 0, *slab_indexes_src = NULL, *slab_indexes_dst = NULL;
+	double *slab_weight_values = NULL;
+	MPI_Status status;
 	
 
 	if (src_original_grid_id != -1) {
@@ -389,21 +480,66 @@ void Remap_weight_of_operator_class::write_overall_remapping_weights(int comp_id
 	}
 	sprintf(full_default_wgt_file_name, "%s/%s", comp_comm_group_mgt_mgr->get_internal_remapping_weights_dir(), default_wgt_file_name);
 	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The default H2D weight file name is \"%s\"", default_wgt_file_name);
-	overall_remap_operator = remap_weights_of_operator_instances[0]->duplicated_remap_operator->gather(comp_id);
+	/* No process gathers the overall sparse matrix. The build uses serial netCDF, so the root opens the weight file once 
+	   and writes the weights of the processes slab by slab, receiving the slab of one process at a time */
+	local_remap_operator = remap_weights_of_operator_instances[0]->duplicated_remap_operator;
+	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, local_remap_operator->get_num_remap_weights_groups() == 1, "Software error in Remap_weight_of_operator_class::write_overall_remapping_weights");
+	owned_sparse_matrix = local_remap_operator->get_remap_weights_group(0)->extract_weights_of_owned_dst_cells(comp_id, weights_offset, num_overall_weights);
 	if (comp_node->get_current_proc_local_id() == 0) {
+		overall_remap_operator = local_remap_operator->duplicate_remap_operator(false);
+		overall_remap_operator->add_weight_sparse_matrix(new Remap_weight_sparse_matrix(overall_remap_operator));
 		Remap_weight_of_operator_instance_class *overall_remap_weight_of_operator_instance = new Remap_weight_of_operator_instance_class(operator_grid_src, operator_grid_dst, 0, remap_weights_of_operator_instances[0]->get_original_remap_operator(), overall_remap_operator);
 		Remap_weight_of_operator_class *overall_remap_weight_of_operator = new Remap_weight_of_operator_class(operator_grid_src, operator_grid_dst, original_remap_operator, operator_grid_src, operator_grid_dst);
 		overall_remap_weight_of_operator->remap_weights_of_operator_instances.push_back(overall_remap_weight_of_operator_instance);
 		Remap_weight_of_strategy_class *overall_remap_weights = new Remap_weight_of_strategy_class("overall_remapping_weights", NULL, operator_grid_src, operator_grid_dst, NULL, false, comp_id);
 		overall_remap_weights->add_remap_weights_of_operator(overall_remap_weight_of_operator);
-		IO_netcdf *io_netcdf = new IO_netcdf(default_wgt_file_name, full_default_wgt_file_name, "w", true);
+		io_netcdf = new IO_netcdf(default_wgt_file_name, full_default_wgt_file_name, "w", true);
 		int last_execution_phase_number = execution_phase_number;
 		execution_phase_number = 1;
-		io_netcdf->write_remap_weights(overall_remap_weights);
+		io_netcdf->write_remap_weights(overall_remap_weights, num_overall_weights);
+		delete overall_remap_weights;
+		io_netcdf->open_remap_weights_for_slabs();
+		io_netcdf->write_remap_weights_slab(weights_offset, owned_sparse_matrix->get_num_weights(), owned_sparse_matrix->get_indexes_src_grid(), owned_sparse_matrix->get_indexes_dst_grid(), owned_sparse_matrix->get_weight_values());
+		for (int i = 1; i < comp_node->get_num_procs(); i ++) {
+			MPI_Recv(slab_info, 2, MPI_LONG, i, 0, comp_node->get_comm_group(), &status);
+			if (slab_info[1] == 0)
+				continue;
+			if (slab_info[1] > max_slab_size) {
+				if (slab_indexes_src != NULL) {
+					delete [] slab_indexes_src;
+					delete [] slab_indexes_dst;
+					delete [] slab_weight_values;
+				}
+				max_slab_size = slab_info[1];
+				slab_indexes_src = new long [max_slab_size];
+				slab_indexes_dst = new long [max_slab_size];
+				slab_weight_values = new double [max_slab_size];
+			}
+			MPI_Recv(slab_indexes_src, slab_info[1], MPI_LONG, i, 1, comp_node->get_comm_group(), &status);
+			MPI_Recv(slab_indexes_dst, slab_info[1], MPI_LONG, i, 2, comp_node->get_comm_group(), &status);
+			MPI_Recv(slab_weight_values, slab_info[1], MPI_DOUBLE, i, 3, comp_node->get_comm_group(), &status);
+			io_netcdf->write_remap_weights_slab(slab_info[0], slab_info[1], slab_indexes_src, slab_indexes_dst, slab_weight_values);
+		}
+		io_netcdf->close_remap_weights_for_slabs();
 		execution_phase_number = last_execution_phase_number;
 		delete io_netcdf;
-		delete overall_remap_weights;
+		if (slab_indexes_src != NULL) {
+			delete [] slab_indexes_src;
+			delete [] slab_indexes_dst;
+			delete [] slab_weight_values;
+		}
 	}
+	else {
+		slab_info[0] = weights_offset;
+		slab_info[1] = owned_sparse_matrix->get_num_weights();
+		MPI_Send(slab_info, 2, MPI_LONG, 0, 0, comp_node->get_comm_group());
+		if (slab_info[1] > 0) {
+			MPI_Send(owned_sparse_matrix->get_indexes_src_grid(), slab_info[1], MPI_LONG, 0, 1, comp_node->get_comm_group());
+			MPI_Send(owned_sparse_matrix->get_indexes_dst_grid(), slab_info[1], MPI_LONG, 0, 2, comp_node->get_comm_group());
+			MPI_Send(owned_sparse_matrix->get_weight_values(), slab_info[1], MPI_DOUBLE, 0, 3, comp_node->get_comm_group());
+		}
+	}
+	delete owned_sparse_matrix;
 }
 
 
@@ -413,6 +549,7 @@ void Remap_weight_of_strategy_class::initialize_object()
     dynamic_vertical_remapping_weights_dst = false;
     public_remap_weights_of_operators = false;
     num_field_data_grids_in_remapping_process = 0;
+    mapped_weight_file = NULL;
 }
 
 
@@ -552,6 +689,93 @@ Remap_weight_of_strategy_class::~Remap_weight_of_strategy_class()
     if (!public_remap_weights_of_operators)
         for (int i = 0; i < remap_weights_of_operators.size(); i ++)
             delete remap_weights_of_operators[i];
+    if (mapped_weight_file != NULL)
+        mapped_weight_file->release_reference();
+    for (int i = 0; i < remap_workspaces.size(); i ++)
+        if (remap_workspaces[i] != NULL)
+            delete remap_workspaces[i];
+    for (int i = 0; i < composed_remap_weights_of_operators.size(); i ++)
+        if (composed_remap_weights_of_operators[i] != NULL)
+            delete composed_remap_weights_of_operators[i];
+}
+
+
+/* Successive H2D operators (e.g., a remapping followed by a smoothing on the dst grid) are composed into one sparse 
+    matrix when remap_composition_fill_in_ratio is set, so that do_remap applies them in one pass without the 
+    intermediate field. The original operators are kept for the weight files and the decomposition calculation */
+void Remap_weight_of_strategy_class::compose_remap_weights_of_operators()
+{
+    Remap_weight_of_operator_class *composed_remap_weights, *next_composed_remap_weights;
+    int i, j;
+
+
+    composed_remap_weights_of_operators.resize(remap_weights_of_operators.size(), NULL);
+    last_composed_operator_indexes.resize(remap_weights_of_operators.size(), -1);
+    if (remap_composition_fill_in_ratio == 0)
+        return;
+
+    for (i = 0; i+1 < remap_weights_of_operators.size(); i = j+1) {
+        composed_remap_weights = NULL;
+        for (j = i; j+1 < remap_weights_of_operators.size(); j ++) {
+            if (remap_weights_of_operators[j]->field_data_grid_dst->is_similar_grid_with(data_grid_dst))
+                break;
+            next_composed_remap_weights = (composed_remap_weights == NULL? remap_weights_of_operators[j] : composed_remap_weights)->compose_with_next_remap_weights(remap_weights_of_operators[j+1], remap_composition_fill_in_ratio);
+            if (next_composed_remap_weights == NULL)
+                break;
+            if (composed_remap_weights != NULL)
+                delete composed_remap_weights;
+            composed_remap_weights = next_composed_remap_weights;
+        }
+        if (composed_remap_weights != NULL) {
+            composed_remap_weights_of_operators[i] = composed_remap_weights;
+            last_composed_operator_indexes[i] = j;
+            EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "The remapping operators %d to %d of \"%s\" are composed into a sparse matrix with %ld weights", i, j, object_name, 
+                                 composed_remap_weights->remap_weights_of_operator_instances[0]->duplicated_remap_operator->get_remap_weights_group(0)->get_num_weights());
+        }
+    }
+}
+
+
+/* The intermediate field data between two successive remap operators are kept as workspaces of the remap strategy, 
+    so that the remapping of each field does not allocate (and page-fault) new temporary buffers */
+void Remap_weight_of_strategy_class::allocate_remap_workspaces()
+{
+    Remap_grid_class *workspace_grid;
+
+
+    remap_workspaces.resize(remap_weights_of_operators.size(), NULL);
+    for (int i = 0; i+1 < remap_weights_of_operators.size(); i ++) {
+        workspace_grid = remap_weights_of_operators[i]->field_data_grid_dst;
+        if (remap_workspaces[i] != NULL && remap_workspaces[i]->get_grid_data_field()->required_data_size == workspace_grid->get_grid_size())
+            continue;
+        if (remap_workspaces[i] != NULL)
+            delete remap_workspaces[i];
+        remap_workspaces[i] = new Remap_grid_data_class("remap_workspace", workspace_grid, NULL, "");
+    }
+}
+
+
+Remap_grid_data_class *Remap_weight_of_strategy_class::get_remap_workspace(int operator_index, Remap_grid_data_class *field_data_src)
+{
+    Remap_data_field *workspace_field, *src_field = field_data_src->get_grid_data_field();
+    Remap_grid_data_class *workspace;
+
+
+    if (operator_index >= remap_workspaces.size() || remap_workspaces[operator_index] == NULL || remap_workspaces[operator_index]->get_grid_data_field()->required_data_size != remap_weights_of_operators[operator_index]->field_data_grid_dst->get_grid_size())
+        allocate_remap_workspaces();
+    workspace = remap_workspaces[operator_index];
+    workspace_field = workspace->get_grid_data_field();
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(src_field->data_type_in_application, workspace_field->data_type_in_application), "Software error in Remap_weight_of_strategy_class::get_remap_workspace: the data type of field \"%s\" is not double", src_field->field_name_in_application);
+
+    strcpy(workspace_field->field_name_in_application, src_field->field_name_in_application);
+    strcpy(workspace_field->field_name_in_IO_file, src_field->field_name_in_IO_file);
+    strcpy(workspace_field->data_type_in_IO_file, src_field->data_type_in_IO_file);
+    workspace_field->field_attributes = src_field->field_attributes;
+    workspace_field->read_data_size = workspace_field->required_data_size;
+    memset(workspace_field->data_buf, 0, workspace_field->required_data_size*get_data_type_size(workspace_field->data_type_in_application));
+    workspace->generate_grid_info(remap_weights_of_operators[operator_index]->field_data_grid_dst);
+
+    return workspace;
 }
 
 
@@ -582,9 +806,10 @@ void Remap_weight_of_strategy_class::do_remap(int comp_id, Remap_grid_data_class
     Remap_grid_class *field_data_grid_src, *field_data_grid_dst;
     Remap_grid_data_class *tmp_field_data_src, *tmp_field_data_dst;
     Remap_operator_basis *current_remap_operator;
+    Remap_weight_of_operator_class *current_remap_weights;
     double *data_value_src, *data_value_dst;
     bool is_last_remap_operator;
-    int i, j, k;
+    int i;
     long remap_beg_iter, remap_end_iter;
     long field_array_offset;
     Remap_grid_class *original_lev_grid_src = NULL, *original_lev_grid_dst = NULL;
@@ -605,30 +830,31 @@ void Remap_weight_of_strategy_class::do_remap(int comp_id, Remap_grid_data_class
     tmp_field_data_dst = field_data_src;
     tmp_field_data_src = NULL;
     for (i = 0; i < remap_weights_of_operators.size(); i ++) {
+        current_remap_weights = remap_weights_of_operators[i];
+        if (i < composed_remap_weights_of_operators.size() && composed_remap_weights_of_operators[i] != NULL) {
+            current_remap_weights = composed_remap_weights_of_operators[i];
+            i = last_composed_operator_indexes[i];
+        }
         if (comp_id != -1)        
-            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, remap_weights_of_operators[i]->get_original_remap_operator()->get_operator_name());
-        if (tmp_field_data_src != NULL && tmp_field_data_src != field_data_src)
-            delete tmp_field_data_src;
+            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, current_remap_weights->get_original_remap_operator()->get_operator_name());
         tmp_field_data_src = tmp_field_data_dst;
-        if (i == remap_weights_of_operators.size()-1 || remap_weights_of_operators[i]->field_data_grid_dst->is_similar_grid_with(field_data_dst->get_coord_value_grid())) {
+        if (i == remap_weights_of_operators.size()-1 || current_remap_weights->field_data_grid_dst->is_similar_grid_with(field_data_dst->get_coord_value_grid())) {
             tmp_field_data_dst = field_data_dst;
-            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, remap_weights_of_operators[i]->field_data_grid_dst->is_similar_grid_with(tmp_field_data_dst->get_coord_value_grid()), 
+            EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, current_remap_weights->field_data_grid_dst->is_similar_grid_with(tmp_field_data_dst->get_coord_value_grid()), 
                          "remap software error1 in do_remap of Remap_weight_of_strategy_class\n");
-			if (i != remap_weights_of_operators.size()-1 && remap_weights_of_operators[i]->field_data_grid_dst->is_similar_grid_with(field_data_dst->get_coord_value_grid()))
+			if (i != remap_weights_of_operators.size()-1 && current_remap_weights->field_data_grid_dst->is_similar_grid_with(field_data_dst->get_coord_value_grid()))
 				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(field_data_dst->get_grid_data_field()->field_name_in_application, V3D_GRID_3D_LEVEL_FIELD_NAME), "Software error in Remap_weight_of_strategy_class::do_remap");
         }    
-        else tmp_field_data_dst = field_data_src->duplicate_grid_data_field(remap_weights_of_operators[i]->field_data_grid_dst, 1, false, false);
-        remap_weights_of_operators[i]->do_remap(comp_id, tmp_field_data_src, tmp_field_data_dst);
+        else tmp_field_data_dst = get_remap_workspace(i, field_data_src);
+        current_remap_weights->do_remap(comp_id, tmp_field_data_src, tmp_field_data_dst);
         if (comp_id != -1)        
-            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, remap_weights_of_operators[i]->get_original_remap_operator()->get_operator_name());
+            comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, current_remap_weights->get_original_remap_operator()->get_operator_name());
 		if (i != remap_weights_of_operators.size()-1 && tmp_field_data_dst == field_data_dst) {
 			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, words_are_the_same(field_data_dst->get_grid_data_field()->field_name_in_application, V3D_GRID_3D_LEVEL_FIELD_NAME), "Software error in Remap_weight_of_strategy_class::do_remap");
 			break;
 		}
     }
 
-    if (tmp_field_data_src != NULL && tmp_field_data_src != field_data_src)
-        delete tmp_field_data_src;
     if (comp_id != -1)          
         comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "interchange data");
     field_data_src->interchange_grid_data(field_data_src->get_coord_value_grid());
@@ -727,11 +953,14 @@ Remap_weight_of_strategy_class *Remap_weight_of_strategy_class::generate_paralle
         if (remap_weights_of_operators[i]->is_remap_weight_empty())
             parallel_remap_weights_of_strategy->remap_weights_of_operators[i]->mark_empty_remap_weight();
 
+    parallel_remap_weights_of_strategy->compose_remap_weights_of_operators();
+    parallel_remap_weights_of_strategy->allocate_remap_workspaces();
+
     return parallel_remap_weights_of_strategy;
 }
 
 
-void Remap_weight_of_strategy_class::write_data_into_array(void *data, int data_size, char **array, long &current_array_size, long &max_array_size)
+void Remap_weight_of_strategy_class::write_data_into_array(void *data, long data_size, char **array, long &current_array_size, long &max_array_size)
 {
     char *new_array;
 
@@ -751,6 +980,17 @@ void Remap_weight_of_strategy_class::write_data_into_array(void *data, int data_
 }
 
 
+void Remap_weight_of_strategy_class::align_array_position(char **array, long &current_array_size, long &max_array_size)
+{
+    char padding[REMAP_WEIGHT_ARRAY_ALIGNMENT];
+
+
+    memset(padding, 0, REMAP_WEIGHT_ARRAY_ALIGNMENT);
+    if (current_array_size % REMAP_WEIGHT_ARRAY_ALIGNMENT != 0)
+        write_data_into_array(padding, REMAP_WEIGHT_ARRAY_ALIGNMENT-current_array_size%REMAP_WEIGHT_ARRAY_ALIGNMENT, array, current_array_size, max_array_size);
+}
+
+
 void Remap_weight_of_strategy_class::write_grid_info_into_array(Remap_grid_class *grid, bool consider_area_or_volumn, char **array, long &current_array_size, long &max_array_size)
 {
     long grid_size;
@@ -846,11 +1086,15 @@ void Remap_weight_of_strategy_class::write_remap_weights_into_array(char **array
                 remap_weights_group = remap_operator_of_one_instance->get_remap_weights_group(j);
                 tmp_long_value = remap_weights_group->get_num_weights();
                 write_data_into_array(&tmp_long_value, sizeof(long), &output_array, array_size, max_array_size);
+                align_array_position(&output_array, array_size, max_array_size);
                 write_data_into_array(remap_weights_group->get_indexes_src_grid(), sizeof(long)*tmp_long_value, &output_array, array_size, max_array_size);
+                align_array_position(&output_array, array_size, max_array_size);
                 write_data_into_array(remap_weights_group->get_indexes_dst_grid(), sizeof(long)*tmp_long_value, &output_array, array_size, max_array_size);
+                align_array_position(&output_array, array_size, max_array_size);
                 write_data_into_array(remap_weights_group->get_weight_values(), sizeof(double)*tmp_long_value, &output_array, array_size, max_array_size);
                 tmp_long_value = remap_weights_group->get_num_remaped_dst_cells_indexes();
                 write_data_into_array(&tmp_long_value, sizeof(long), &output_array, array_size, max_array_size);
+                align_array_position(&output_array, array_size, max_array_size);
                 write_data_into_array(remap_weights_group->get_remaped_dst_cells_indexes(), sizeof(long)*tmp_long_value, &output_array, array_size, max_array_size);
             }
         }
@@ -859,7 +1103,7 @@ void Remap_weight_of_strategy_class::write_remap_weights_into_array(char **array
 }
 
 
-void Remap_weight_of_strategy_class::read_data_from_array(void *data, int data_size, const char *input_array, FILE *fp_binary, long &current_array_pos, long array_size, bool read_weight_values)
+void Remap_weight_of_strategy_class::read_data_from_array(void *data, long data_size, const char *input_array, FILE *fp_binary, long &current_array_pos, long array_size, bool read_weight_values)
 {
     EXECUTION_REPORT(REPORT_ERROR, -1, current_array_pos+data_size <= array_size, "the access of array is out-of-bound when reading for remapping weights %s", object_name);
 
@@ -876,6 +1120,32 @@ void Remap_weight_of_strategy_class::read_data_from_array(void *data, int data_s
 }
 
 
+void *Remap_weight_of_strategy_class::map_data_from_array(long data_size, const char *input_array, long &current_array_pos, long array_size)
+{
+    void *data = (void*) (input_array+current_array_pos);
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, current_array_pos+data_size <= array_size, "the access of array is out-of-bound when mapping for remapping weights %s", object_name);
+    current_array_pos += data_size;
+
+    return data;
+}
+
+
+void Remap_weight_of_strategy_class::skip_array_alignment(FILE *fp_binary, long &current_array_pos, long array_size)
+{
+    long padding_size = 0;
+
+
+    if (current_array_pos % REMAP_WEIGHT_ARRAY_ALIGNMENT != 0)
+        padding_size = REMAP_WEIGHT_ARRAY_ALIGNMENT - current_array_pos % REMAP_WEIGHT_ARRAY_ALIGNMENT;
+    EXECUTION_REPORT(REPORT_ERROR, -1, current_array_pos+padding_size <= array_size, "the access of array is out-of-bound when reading for remapping weights %s", object_name);
+    if (fp_binary != NULL)
+        fseek(fp_binary, padding_size, SEEK_CUR);
+    current_array_pos += padding_size;
+}
+
+
 void Remap_weight_of_strategy_class::read_grid_info_from_array(Remap_grid_class *grid, bool consider_area_or_volumn, const char *input_array, FILE *fp_binary, long &current_array_pos, long array_size)
 {
     long grid_size;
@@ -929,6 +1199,7 @@ void Remap_weight_of_strategy_class::read_remap_operator_instance_from_array(Rem
     long num_weights, num_remaped_dst_cells_indexes, *indexes_src_grid, *indexes_dst_grid, *remaped_dst_cells_indexes;
     Remap_weight_sparse_matrix *weight_sparse_matrix;
     double *weight_values;
+    bool map_weight_arrays = read_weight_values && mapped_weight_file != NULL && input_array != NULL;
 
 
     if (read_weight_values)
@@ -937,20 +1208,39 @@ void Remap_weight_of_strategy_class::read_remap_operator_instance_from_array(Rem
     read_data_from_array(&num_remap_weights_groups, sizeof(int), input_array, fp_binary, current_array_pos, array_size, true);
     for (i = 0; i < num_remap_weights_groups; i ++) {
         read_data_from_array(&num_weights, sizeof(long), input_array, fp_binary, current_array_pos, array_size, true);
-        if (read_weight_values) {
-            indexes_src_grid = new long [num_weights];
-            indexes_dst_grid = new long [num_weights];
-            weight_values = new double [num_weights];
+        if (map_weight_arrays) {
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            indexes_src_grid = (long*) map_data_from_array(sizeof(long)*num_weights, input_array, current_array_pos, array_size);
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            indexes_dst_grid = (long*) map_data_from_array(sizeof(long)*num_weights, input_array, current_array_pos, array_size);
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            weight_values = (double*) map_data_from_array(sizeof(double)*num_weights, input_array, current_array_pos, array_size);
+            read_data_from_array(&num_remaped_dst_cells_indexes, sizeof(long), input_array, fp_binary, current_array_pos, array_size, true);
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            remaped_dst_cells_indexes = (long*) map_data_from_array(sizeof(long)*num_remaped_dst_cells_indexes, input_array, current_array_pos, array_size);
+        }
+        else {
+            if (read_weight_values) {
+                indexes_src_grid = new long [num_weights];
+                indexes_dst_grid = new long [num_weights];
+                weight_values = new double [num_weights];
+            }
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            read_data_from_array(indexes_src_grid, sizeof(long)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            read_data_from_array(indexes_dst_grid, sizeof(long)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            read_data_from_array(weight_values, sizeof(double)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
+            read_data_from_array(&num_remaped_dst_cells_indexes, sizeof(long), input_array, fp_binary, current_array_pos, array_size, true);
+            if (read_weight_values)
+                remaped_dst_cells_indexes = new long [num_remaped_dst_cells_indexes];
+            skip_array_alignment(fp_binary, current_array_pos, array_size);
+            read_data_from_array(remaped_dst_cells_indexes, sizeof(long)*num_remaped_dst_cells_indexes, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
         }
-        read_data_from_array(indexes_src_grid, sizeof(long)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
-        read_data_from_array(indexes_dst_grid, sizeof(long)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
-        read_data_from_array(weight_values, sizeof(double)*num_weights, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
-        read_data_from_array(&num_remaped_dst_cells_indexes, sizeof(long), input_array, fp_binary, current_array_pos, array_size, true);
-        if (read_weight_values)
-            remaped_dst_cells_indexes = new long [num_remaped_dst_cells_indexes];
-        read_data_from_array(remaped_dst_cells_indexes, sizeof(long)*num_remaped_dst_cells_indexes, input_array, fp_binary, current_array_pos, array_size, read_weight_values);
         if (read_weight_values) {
             weight_sparse_matrix = new Remap_weight_sparse_matrix(remap_operator, num_weights, indexes_src_grid, indexes_dst_grid, weight_values, num_remaped_dst_cells_indexes, remaped_dst_cells_indexes);
+            if (map_weight_arrays)
+                weight_sparse_matrix->set_mapped_weight_file(mapped_weight_file);
             duplicated_remap_operator->add_weight_sparse_matrix(weight_sparse_matrix);
         }
     }
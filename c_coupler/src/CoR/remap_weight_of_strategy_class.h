@@ -17,9 +17,13 @@
 #include <vector>
 
 
+#define REMAP_WEIGHT_ARRAY_ALIGNMENT        64
+
+
 class Remap_operator_basis;
 class Remap_strategy_class;
 class Remap_weight_sparse_matrix;
+class Mapped_weight_file;
 class Remap_weight_of_strategy_class;
 class Remap_weight_of_operator_class;
 
@@ -66,6 +70,10 @@ class Remap_weight_of_operator_class
         Remap_operator_basis *original_remap_operator;
         std::vector<Remap_weight_of_operator_instance_class*> remap_weights_of_operator_instances;
         bool empty_remap_weight;
+        std::vector<long> column_offsets_src;
+        std::vector<long> column_offsets_dst;
+        std::vector<double> column_buffer_src;
+        std::vector<double> column_buffer_dst;
         
     public: 
         Remap_weight_of_operator_class(Remap_grid_class*, Remap_grid_class*, Remap_operator_basis*, Remap_grid_class*, Remap_grid_class*);
@@ -82,6 +90,8 @@ class Remap_weight_of_operator_class
         void renew_vertical_remap_weights(Remap_grid_class *runtime_remap_grid_src, Remap_grid_class *runtime_remap_grid_dst);
         void mark_empty_remap_weight() { empty_remap_weight = true; }
         bool is_remap_weight_empty() { return empty_remap_weight; }        
+        bool is_single_column_H2D_remapping();
+        Remap_weight_of_operator_class *compose_with_next_remap_weights(Remap_weight_of_operator_class*, long);
 		void write_overall_remapping_weights(int, int, int);
 };
 
@@ -100,12 +110,21 @@ class Remap_weight_of_strategy_class
         int num_field_data_grids_in_remapping_process;
         Remap_grid_class *field_data_grids_in_remapping_process[512];
         Remap_grid_data_class *runtime_mask_fields_in_remapping_process[512];
+        Mapped_weight_file *mapped_weight_file;
+        std::vector<Remap_grid_data_class*> remap_workspaces;
+        std::vector<Remap_weight_of_operator_class*> composed_remap_weights_of_operators;
+        std::vector<int> last_composed_operator_indexes;
 
         void read_grid_info_from_array(Remap_grid_class*, bool, const char *, FILE*, long&, long);
-        void read_data_from_array(void*, int, const char*, FILE*, long&, long, bool);
+        void read_data_from_array(void*, long, const char*, FILE*, long&, long, bool);
+        void *map_data_from_array(long, const char*, long&, long);
+        void skip_array_alignment(FILE*, long&, long);
         void read_remap_operator_instance_from_array(Remap_grid_class*, Remap_grid_class*, Remap_grid_class*, Remap_grid_class*, Remap_operator_basis*, long, long, const char*, FILE*, long&, long, bool);
         void write_grid_info_into_array(Remap_grid_class*, bool, char **, long&, long &);
-        void write_data_into_array(void*, int, char**, long&, long &);
+        void write_data_into_array(void*, long, char**, long&, long &);
+        void align_array_position(char**, long&, long &);
+        Remap_grid_data_class *get_remap_workspace(int, Remap_grid_data_class*);
+        void compose_remap_weights_of_operators();
 
     public:
         Remap_weight_of_strategy_class(const char*, const char*, const char*, const char*, const char*, const char*, bool);
@@ -123,6 +142,7 @@ class Remap_weight_of_strategy_class
         Remap_operator_basis *get_unique_remap_operator_of_weights();
         Remap_weight_of_operator_instance_class *add_remap_weight_of_operator_instance(Remap_grid_class*, Remap_grid_class*, long, Remap_operator_basis*);
         void do_remap(int, Remap_grid_data_class*, Remap_grid_data_class*);
+        void allocate_remap_workspaces();
         void add_remap_weight_of_operator_instance(Remap_weight_of_operator_instance_class *, Remap_grid_class *, Remap_grid_class *, Remap_operator_basis *, Remap_grid_class *, Remap_grid_class *);
         void calculate_src_decomp(Remap_grid_class*, Remap_grid_class*, long*, const long*);
 		void get_remap_related_grids(std::vector<std::pair<Remap_grid_class *, bool> > &);		
@@ -132,6 +152,7 @@ class Remap_weight_of_strategy_class
         void renew_object_name(const char*);
         void write_remap_weights_into_array(char**, long&, bool);
         void read_remap_weights_from_array(const char*, FILE*, long, bool, Remap_grid_class**, bool);
+        void set_mapped_weight_file(Mapped_weight_file *mapped_weight_file) { this->mapped_weight_file = mapped_weight_file; }
         void check_remap_weights_format();
         void add_remap_weight_of_operators_to_manager(bool);
         int get_num_remap_weights_of_operators() { return remap_weights_of_operators.size(); }
@@ -14,6 +14,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <vector>
+#include <algorithm>
+#include <sys/mman.h>
+
+
+void Mapped_weight_file::release_reference()
+{
+    num_references --;
+    if (num_references > 0)
+        return;
+    munmap(address, size);
+    delete this;
+}
 
 
 Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *remap_operator, 
@@ -28,6 +41,7 @@ Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *rem
     this->weight_values = weight_values;
     this->remaped_dst_cells_indexes = remaped_dst_cells_indexes;
     this->num_remaped_dst_cells_indexes = num_remaped_dst_cells_indexes;
+    this->mapped_weight_file = NULL;
     
     if (remaped_dst_cells_indexes == NULL) {
         int *mask = new int [remap_operator->get_dst_grid()->get_grid_size()];
@@ -62,11 +76,16 @@ Remap_weight_sparse_matrix::Remap_weight_sparse_matrix(Remap_operator_basis *rem
     cells_indexes_dst = new long [weight_arrays_size];
     weight_values = new double [weight_arrays_size];
     remaped_dst_cells_indexes = new long [remaped_dst_cells_indexes_array_size];
+    mapped_weight_file = NULL;
 }
 
 
 Remap_weight_sparse_matrix::~Remap_weight_sparse_matrix()
 {
+    if (mapped_weight_file != NULL) {
+        mapped_weight_file->release_reference();
+        return;
+    }
     delete [] cells_indexes_src;
     delete [] cells_indexes_dst;
     if (remaped_dst_cells_indexes != NULL)
@@ -75,6 +94,33 @@ Remap_weight_sparse_matrix::~Remap_weight_sparse_matrix()
 }
 
 
+void Remap_weight_sparse_matrix::copy_mapped_weight_arrays()
+{
+    long *mapped_indexes_src = cells_indexes_src, *mapped_indexes_dst = cells_indexes_dst, *mapped_remaped_dst_cells_indexes = remaped_dst_cells_indexes;
+    double *mapped_weight_values = weight_values;
+
+
+    cells_indexes_src = new long [weight_arrays_size];
+    cells_indexes_dst = new long [weight_arrays_size];
+    weight_values = new double [weight_arrays_size];
+    remaped_dst_cells_indexes = new long [remaped_dst_cells_indexes_array_size];
+    memcpy(cells_indexes_src, mapped_indexes_src, weight_arrays_size*sizeof(long));
+    memcpy(cells_indexes_dst, mapped_indexes_dst, weight_arrays_size*sizeof(long));
+    memcpy(weight_values, mapped_weight_values, weight_arrays_size*sizeof(double));
+    memcpy(remaped_dst_cells_indexes, mapped_remaped_dst_cells_indexes, remaped_dst_cells_indexes_array_size*sizeof(long));
+    mapped_weight_file->release_reference();
+    mapped_weight_file = NULL;
+}
+
+
+void Remap_weight_sparse_matrix::set_mapped_weight_file(Mapped_weight_file *mapped_weight_file)
+{
+    EXECUTION_REPORT(REPORT_ERROR, -1, this->mapped_weight_file == NULL, "C-Coupler error in set_mapped_weight_file of Remap_weight_sparse_matrix");
+    mapped_weight_file->add_reference();
+    this->mapped_weight_file = mapped_weight_file;
+}
+
+
 void Remap_weight_sparse_matrix::clear_weights_info()
 {
     num_weights = 0; 
@@ -94,6 +140,9 @@ void Remap_weight_sparse_matrix::add_weights(long *indexes_src, long index_dst,
             EXECUTION_REPORT(REPORT_ERROR, -1, indexes_src[i] >= 0 && indexes_src[i] < remap_operator->get_src_grid()->get_grid_size(), "C-Coupler error1 in add_weights of Remap_weight_sparse_matrix");
         EXECUTION_REPORT(REPORT_ERROR, -1, remap_operator->get_dst_grid() != NULL && index_dst >= 0 && index_dst < remap_operator->get_dst_grid()->get_grid_size(), "C-Coupler error2 in add_weights of Remap_weight_sparse_matrix");
     }
+
+    if (mapped_weight_file != NULL)
+        copy_mapped_weight_arrays();
     
     if (num_weights + num_added_weights > weight_arrays_size) {
         new_array_size = 2 * (num_weights+num_added_weights);
@@ -190,7 +239,7 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::duplicate_remap_weight_o
 Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::generate_parallel_remap_weight_of_sparse_matrix(Remap_grid_class **decomp_original_grids, int **global_cells_local_indexes_in_decomps)
 {
     Remap_weight_sparse_matrix *parallel_remap_weight_of_sparse_matrix;
-    long i, num_parallel_weights, num_remaped_dst_cells;
+    long i, num_parallel_weights, num_remaped_dst_cells, *global_indexes_src;
 
 
     EXECUTION_REPORT(REPORT_ERROR, -1, decomp_original_grids[0]->is_subset_of_grid(remap_operator->get_src_grid()) && decomp_original_grids[1]->is_subset_of_grid(remap_operator->get_dst_grid()), 
@@ -222,6 +271,7 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::generate_parallel_remap_
         parallel_remap_weight_of_sparse_matrix->cells_indexes_dst = new long [num_parallel_weights];
         parallel_remap_weight_of_sparse_matrix->weight_values = new double [num_parallel_weights];
         parallel_remap_weight_of_sparse_matrix->remaped_dst_cells_indexes = new long [num_remaped_dst_cells]; 
+        global_indexes_src = new long [num_parallel_weights];
         num_parallel_weights = 0;
         num_remaped_dst_cells = 0;
         for (i = 0; i < this->num_weights; i ++) {
@@ -229,12 +279,15 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::generate_parallel_remap_
                 parallel_remap_weight_of_sparse_matrix->weight_values[num_parallel_weights] = this->weight_values[i];
                 parallel_remap_weight_of_sparse_matrix->cells_indexes_src[num_parallel_weights] = global_cells_local_indexes_in_decomps[0][this->cells_indexes_src[i]];
                 parallel_remap_weight_of_sparse_matrix->cells_indexes_dst[num_parallel_weights] = global_cells_local_indexes_in_decomps[1][this->cells_indexes_dst[i]];
+                global_indexes_src[num_parallel_weights] = this->cells_indexes_src[i];
                 num_parallel_weights ++;
             }
         }
         for (i = 0; i < this->num_remaped_dst_cells_indexes; i ++) 
             if (global_cells_local_indexes_in_decomps[1][this->remaped_dst_cells_indexes[i]] != -1)
                 parallel_remap_weight_of_sparse_matrix->remaped_dst_cells_indexes[num_remaped_dst_cells++] = global_cells_local_indexes_in_decomps[1][this->remaped_dst_cells_indexes[i]];
+        parallel_remap_weight_of_sparse_matrix->reorder_weights_for_locality(global_indexes_src);
+        delete [] global_indexes_src;
     }
     else if (decomp_original_grids[0]->get_num_dimensions() == 3) {
         EXECUTION_REPORT(REPORT_ERROR, -1, false, "the parallelization of 3D remapping algorithm has not been supported now\n");
@@ -247,6 +300,197 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::generate_parallel_remap_
 }
 
 
+/* Sorts the weights by the local destination cells and then by the given source keys, and merges the weights of 
+    the same (src, dst) pair, so that remap_values writes each destination cell once and gathers the source values 
+    of a destination cell in ascending order. The global source indexes are used as keys rather than the local ones, 
+    so that the summation order of every destination cell does not depend on the parallel decomposition */
+void Remap_weight_sparse_matrix::reorder_weights_for_locality(const long *src_sort_keys)
+{
+    long *sorted_indexes_src, *sorted_indexes_dst, *sorted_keys, *displs_of_dst_cells, num_dst_cells = 0, i, j, k, l, index_dst;
+    double *sorted_weight_values;
+    std::vector<std::pair<long, long> > run_keys;
+    std::vector<long> run_indexes_src;
+    std::vector<double> run_weight_values;
+
+
+    if (num_weights == 0)
+        return;
+
+    for (i = 0; i < num_weights; i ++)
+        if (num_dst_cells <= cells_indexes_dst[i])
+            num_dst_cells = cells_indexes_dst[i] + 1;
+    displs_of_dst_cells = new long [num_dst_cells+1];
+    for (i = 0; i <= num_dst_cells; i ++)
+        displs_of_dst_cells[i] = 0;
+    for (i = 0; i < num_weights; i ++)
+        displs_of_dst_cells[cells_indexes_dst[i]+1] ++;
+    for (i = 0; i < num_dst_cells; i ++)
+        displs_of_dst_cells[i+1] += displs_of_dst_cells[i];
+
+    sorted_indexes_src = new long [weight_arrays_size];
+    sorted_indexes_dst = new long [weight_arrays_size];
+    sorted_weight_values = new double [weight_arrays_size];
+    sorted_keys = new long [num_weights];
+    for (i = 0; i < num_weights; i ++) {
+        j = displs_of_dst_cells[cells_indexes_dst[i]] ++;
+        sorted_indexes_src[j] = cells_indexes_src[i];
+        sorted_indexes_dst[j] = cells_indexes_dst[i];
+        sorted_weight_values[j] = weight_values[i];
+        sorted_keys[j] = src_sort_keys[i];
+    }
+
+    /* The weights of each dst cell are sorted as (key, position) pairs, so that the weights with the same key keep 
+        their original order and are merged in that order */
+    for (i = 0, k = 0; i < num_weights; i = j) {
+        for (j = i+1; j < num_weights && sorted_indexes_dst[j] == sorted_indexes_dst[i]; j ++);
+        index_dst = sorted_indexes_dst[i];
+        run_keys.clear();
+        run_indexes_src.clear();
+        run_weight_values.clear();
+        for (l = i; l < j; l ++)
+            run_keys.push_back(std::make_pair(sorted_keys[l], l));
+        std::sort(run_keys.begin(), run_keys.end());
+        for (l = 0; l < run_keys.size(); l ++) {
+            run_indexes_src.push_back(sorted_indexes_src[run_keys[l].second]);
+            run_weight_values.push_back(sorted_weight_values[run_keys[l].second]);
+        }
+        for (l = 0; l < run_keys.size(); l ++) {
+            if (l > 0 && run_keys[l].first == run_keys[l-1].first) {
+                sorted_weight_values[k-1] += run_weight_values[l];
+                continue;
+            }
+            sorted_keys[k] = run_keys[l].first;
+            sorted_indexes_src[k] = run_indexes_src[l];
+            sorted_indexes_dst[k] = index_dst;
+            sorted_weight_values[k] = run_weight_values[l];
+            k ++;
+        }
+    }
+
+    delete [] cells_indexes_src;
+    delete [] cells_indexes_dst;
+    delete [] weight_values;
+    delete [] sorted_keys;
+    delete [] displs_of_dst_cells;
+    cells_indexes_src = sorted_indexes_src;
+    cells_indexes_dst = sorted_indexes_dst;
+    weight_values = sorted_weight_values;
+    num_weights = k;
+}
+
+
+/* Generates the sparse matrix of applying previous_sparse_matrix and then this sparse matrix, so that a chain of two 
+    operators becomes one remapping pass. The intermediate cells that are not remapped by previous_sparse_matrix are 
+    zero, as in the intermediate workspaces. NULL is returned when the product has more than max_num_weights weights */
+Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::compose_with_previous_sparse_matrix(Remap_weight_sparse_matrix *previous_sparse_matrix, Remap_operator_basis *composed_remap_operator, long max_num_weights)
+{
+    long num_mid_cells = 0, num_src_cells = 0, num_dst_cells = 0, num_composed_weights = 0, row_begin, i, j, k, index_mid, index_src;
+    long *displs_of_mid_cells, *previous_indexes_src, *displs_of_dst_cells, *this_indexes_mid, *row_positions;
+    long *composed_indexes_src = NULL, *composed_indexes_dst = NULL, *composed_remaped_dst_cells_indexes;
+    double *previous_weight_values, *this_weight_values, *composed_weight_values = NULL;
+    std::vector<long> composed_indexes_src_buffer, composed_indexes_dst_buffer;
+    std::vector<double> composed_weight_values_buffer;
+    bool too_many_weights = false;
+
+
+    for (i = 0; i < previous_sparse_matrix->num_weights; i ++) {
+        if (num_mid_cells <= previous_sparse_matrix->cells_indexes_dst[i])
+            num_mid_cells = previous_sparse_matrix->cells_indexes_dst[i] + 1;
+        if (num_src_cells <= previous_sparse_matrix->cells_indexes_src[i])
+            num_src_cells = previous_sparse_matrix->cells_indexes_src[i] + 1;
+    }
+    for (i = 0; i < num_weights; i ++)
+        if (num_dst_cells <= cells_indexes_dst[i])
+            num_dst_cells = cells_indexes_dst[i] + 1;
+
+    displs_of_mid_cells = new long [num_mid_cells+1];
+    previous_indexes_src = new long [previous_sparse_matrix->num_weights];
+    previous_weight_values = new double [previous_sparse_matrix->num_weights];
+    for (i = 0; i <= num_mid_cells; i ++)
+        displs_of_mid_cells[i] = 0;
+    for (i = 0; i < previous_sparse_matrix->num_weights; i ++)
+        displs_of_mid_cells[previous_sparse_matrix->cells_indexes_dst[i]+1] ++;
+    for (i = 0; i < num_mid_cells; i ++)
+        displs_of_mid_cells[i+1] += displs_of_mid_cells[i];
+    for (i = 0; i < previous_sparse_matrix->num_weights; i ++) {
+        j = displs_of_mid_cells[previous_sparse_matrix->cells_indexes_dst[i]] ++;
+        previous_indexes_src[j] = previous_sparse_matrix->cells_indexes_src[i];
+        previous_weight_values[j] = previous_sparse_matrix->weight_values[i];
+    }
+    for (i = num_mid_cells; i > 0; i --)
+        displs_of_mid_cells[i] = displs_of_mid_cells[i-1];
+    displs_of_mid_cells[0] = 0;
+
+    displs_of_dst_cells = new long [num_dst_cells+1];
+    this_indexes_mid = new long [num_weights];
+    this_weight_values = new double [num_weights];
+    for (i = 0; i <= num_dst_cells; i ++)
+        displs_of_dst_cells[i] = 0;
+    for (i = 0; i < num_weights; i ++)
+        displs_of_dst_cells[cells_indexes_dst[i]+1] ++;
+    for (i = 0; i < num_dst_cells; i ++)
+        displs_of_dst_cells[i+1] += displs_of_dst_cells[i];
+    for (i = 0; i < num_weights; i ++) {
+        j = displs_of_dst_cells[cells_indexes_dst[i]] ++;
+        this_indexes_mid[j] = cells_indexes_src[i];
+        this_weight_values[j] = weight_values[i];
+    }
+    for (i = num_dst_cells; i > 0; i --)
+        displs_of_dst_cells[i] = displs_of_dst_cells[i-1];
+    displs_of_dst_cells[0] = 0;
+
+    row_positions = new long [num_src_cells];
+    for (i = 0; i < num_src_cells; i ++)
+        row_positions[i] = -1;
+    for (i = 0; i < num_dst_cells && !too_many_weights; i ++) {
+        row_begin = composed_weight_values_buffer.size();
+        for (j = displs_of_dst_cells[i]; j < displs_of_dst_cells[i+1]; j ++) {
+            index_mid = this_indexes_mid[j];
+            if (index_mid >= num_mid_cells)
+                continue;
+            for (k = displs_of_mid_cells[index_mid]; k < displs_of_mid_cells[index_mid+1]; k ++) {
+                index_src = previous_indexes_src[k];
+                if (row_positions[index_src] == -1) {
+                    row_positions[index_src] = composed_weight_values_buffer.size();
+                    composed_indexes_src_buffer.push_back(index_src);
+                    composed_indexes_dst_buffer.push_back(i);
+                    composed_weight_values_buffer.push_back(this_weight_values[j]*previous_weight_values[k]);
+                }
+                else composed_weight_values_buffer[row_positions[index_src]] += this_weight_values[j]*previous_weight_values[k];
+            }
+        }
+        for (j = row_begin; j < composed_indexes_src_buffer.size(); j ++)
+            row_positions[composed_indexes_src_buffer[j]] = -1;
+        too_many_weights = composed_weight_values_buffer.size() > max_num_weights;
+    }
+
+    delete [] displs_of_mid_cells;
+    delete [] previous_indexes_src;
+    delete [] previous_weight_values;
+    delete [] displs_of_dst_cells;
+    delete [] this_indexes_mid;
+    delete [] this_weight_values;
+    delete [] row_positions;
+
+    if (too_many_weights)
+        return NULL;
+
+    num_composed_weights = composed_weight_values_buffer.size();
+    composed_indexes_src = new long [num_composed_weights];
+    composed_indexes_dst = new long [num_composed_weights];
+    composed_weight_values = new double [num_composed_weights];
+    composed_remaped_dst_cells_indexes = new long [num_remaped_dst_cells_indexes];
+    for (i = 0; i < num_composed_weights; i ++) {
+        composed_indexes_src[i] = composed_indexes_src_buffer[i];
+        composed_indexes_dst[i] = composed_indexes_dst_buffer[i];
+        composed_weight_values[i] = composed_weight_values_buffer[i];
+    }
+    memcpy(composed_remaped_dst_cells_indexes, remaped_dst_cells_indexes, num_remaped_dst_cells_indexes*sizeof(long));
+
+    return new Remap_weight_sparse_matrix(composed_remap_operator, num_composed_weights, composed_indexes_src, composed_indexes_dst, composed_weight_values, num_remaped_dst_cells_indexes, composed_remaped_dst_cells_indexes);
+}
+
+
 void Remap_weight_sparse_matrix::compare_to_another_sparse_matrix(Remap_weight_sparse_matrix *another_sparse_matrix)
 {
     EXECUTION_REPORT(REPORT_ERROR, -1, this->num_weights == another_sparse_matrix->num_weights, "C-Coupler error1 in compare_to_another_sparse_matrix");
@@ -322,3 +566,83 @@ Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::gather(int comp_id)
 }
 
 
+/* Keeps the weights whose dst cells are owned by the current process, where a dst cell is owned by the process with 
+    the smallest id among the processes that have weights of it (the same as the removal of repeated weights in gather). 
+    The owners are resolved by the process of each block of dst cells, so that no process holds an array of the whole 
+    dst grid. weights_offset is the position of the kept weights in the overall sparse matrix ordered by the process ids */
+Remap_weight_sparse_matrix *Remap_weight_sparse_matrix::extract_weights_of_owned_dst_cells(int comp_id, long &weights_offset, long &num_overall_weights)
+{
+    Comp_comm_group_mgt_node *comp_node = comp_comm_group_mgt_mgr->search_global_node(comp_id);
+    int num_procs = comp_node->get_num_procs(), current_proc_id = comp_node->get_current_proc_local_id();
+    long dst_grid_size = remap_operator->get_dst_grid()->get_grid_size(), block_size = (dst_grid_size+num_procs-1) / num_procs;
+    std::vector<long> local_dst_cells(cells_indexes_dst, cells_indexes_dst+num_weights);
+    int *send_counts = new int [num_procs], *send_displs = new int [num_procs], *recv_counts = new int [num_procs], *recv_displs = new int [num_procs];
+    int *block_cells_owner = new int [block_size], *requested_cells_owner, *local_dst_cells_owner, num_requested_cells, owner;
+    long *requested_cells, *owned_indexes_src, *owned_indexes_dst, num_owned_weights = 0, num_all_weights, i, j;
+    double *owned_weight_values;
+
+
+    std::sort(local_dst_cells.begin(), local_dst_cells.end());
+    local_dst_cells.erase(std::unique(local_dst_cells.begin(), local_dst_cells.end()), local_dst_cells.end());
+    for (i = 0; i < num_procs; i ++)
+        send_counts[i] = 0;
+    for (i = 0; i < local_dst_cells.size(); i ++)
+        send_counts[local_dst_cells[i]/block_size] ++;
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, comp_node->get_comm_group());
+    send_displs[0] = recv_displs[0] = 0;
+    for (i = 1; i < num_procs; i ++) {
+        send_displs[i] = send_displs[i-1] + send_counts[i-1];
+        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+    }
+    num_requested_cells = recv_displs[num_procs-1] + recv_counts[num_procs-1];
+    requested_cells = new long [num_requested_cells];
+    requested_cells_owner = new int [num_requested_cells];
+    local_dst_cells_owner = new int [local_dst_cells.size()];
+    MPI_Alltoallv(local_dst_cells.data(), send_counts, send_displs, MPI_LONG, requested_cells, recv_counts, recv_displs, MPI_LONG, comp_node->get_comm_group());
+
+    for (i = 0; i < block_size; i ++)
+        block_cells_owner[i] = num_procs;
+    for (i = 0; i < num_procs; i ++)
+        for (j = recv_displs[i]; j < recv_displs[i]+recv_counts[i]; j ++)
+            if (block_cells_owner[requested_cells[j]-current_proc_id*block_size] > i)
+                block_cells_owner[requested_cells[j]-current_proc_id*block_size] = i;
+    for (j = 0; j < num_requested_cells; j ++)
+        requested_cells_owner[j] = block_cells_owner[requested_cells[j]-current_proc_id*block_size];
+    MPI_Alltoallv(requested_cells_owner, recv_counts, recv_displs, MPI_INT, local_dst_cells_owner, send_counts, send_displs, MPI_INT, comp_node->get_comm_group());
+
+    for (i = 0; i < num_weights; i ++)
+        if (local_dst_cells_owner[std::lower_bound(local_dst_cells.begin(), local_dst_cells.end(), cells_indexes_dst[i])-local_dst_cells.begin()] == current_proc_id)
+            num_owned_weights ++;
+    owned_indexes_src = new long [num_owned_weights];
+    owned_indexes_dst = new long [num_owned_weights];
+    owned_weight_values = new double [num_owned_weights];
+    for (i = 0, num_owned_weights = 0; i < num_weights; i ++) {
+        owner = local_dst_cells_owner[std::lower_bound(local_dst_cells.begin(), local_dst_cells.end(), cells_indexes_dst[i])-local_dst_cells.begin()];
+        if (owner == current_proc_id) {
+            owned_indexes_src[num_owned_weights] = cells_indexes_src[i];
+            owned_indexes_dst[num_owned_weights] = cells_indexes_dst[i];
+            owned_weight_values[num_owned_weights] = weight_values[i];
+            num_owned_weights ++;
+        }
+    }
+    delete [] send_counts;
+    delete [] send_displs;
+    delete [] recv_counts;
+    delete [] recv_displs;
+    delete [] block_cells_owner;
+    delete [] requested_cells;
+    delete [] requested_cells_owner;
+    delete [] local_dst_cells_owner;
+
+    weights_offset = 0;
+    MPI_Exscan(&num_owned_weights, &weights_offset, 1, MPI_LONG, MPI_SUM, comp_node->get_comm_group());
+    if (current_proc_id == 0)
+        weights_offset = 0;
+    MPI_Allreduce(&num_owned_weights, &num_overall_weights, 1, MPI_LONG, MPI_SUM, comp_node->get_comm_group());
+    MPI_Allreduce(&num_weights, &num_all_weights, 1, MPI_LONG, MPI_SUM, comp_node->get_comm_group());
+    if (num_all_weights != num_overall_weights)
+        EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "When generating the overall remapping sparse matrix, repeated remapping weights are detected: %ld vs %ld", num_all_weights, num_overall_weights);
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The overall remapping sparse matrix have %ld weights", num_overall_weights);
+
+    return new Remap_weight_sparse_matrix(remap_operator, num_owned_weights, owned_indexes_src, owned_indexes_dst, owned_weight_values, 0, NULL);
+}
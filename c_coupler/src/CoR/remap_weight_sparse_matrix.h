@@ -17,6 +17,22 @@
 class Remap_operator_basis;
 
 
+/* A binary weight file mapped read-only into memory. The sparse matrices that point into the mapping hold references 
+    to it, and the last released reference unmaps the file */
+class Mapped_weight_file
+{
+    private:
+        void *address;
+        long size;
+        int num_references;
+
+    public:
+        Mapped_weight_file(void *address, long size) { this->address = address; this->size = size; num_references = 1; }
+        void add_reference() { num_references ++; }
+        void release_reference();
+};
+
+
 class Remap_weight_sparse_matrix
 {
     private:
@@ -29,6 +45,10 @@ class Remap_weight_sparse_matrix
         long num_weights;
         long remaped_dst_cells_indexes_array_size;
         long num_remaped_dst_cells_indexes;
+        Mapped_weight_file *mapped_weight_file;
+
+        void copy_mapped_weight_arrays();
+        void reorder_weights_for_locality(const long*);
         
     public:
         Remap_weight_sparse_matrix(Remap_operator_basis*);
@@ -41,6 +61,7 @@ class Remap_weight_sparse_matrix
         void calc_src_decomp(long*, const long*);
         Remap_weight_sparse_matrix *duplicate_remap_weight_of_sparse_matrix();
         Remap_weight_sparse_matrix *generate_parallel_remap_weight_of_sparse_matrix(Remap_grid_class **, int **);
+        Remap_weight_sparse_matrix *compose_with_previous_sparse_matrix(Remap_weight_sparse_matrix*, Remap_operator_basis*, long);
         Remap_operator_basis *get_remap_operator() { return remap_operator; }
         long get_num_weights() { return num_weights; }
         long *get_indexes_src_grid() { return cells_indexes_src; }
@@ -48,9 +69,11 @@ class Remap_weight_sparse_matrix
         long get_num_remaped_dst_cells_indexes() { return num_remaped_dst_cells_indexes; }
         long *get_remaped_dst_cells_indexes() { return remaped_dst_cells_indexes; }
         double *get_weight_values() { return weight_values; }
+        void set_mapped_weight_file(Mapped_weight_file*);
         void compare_to_another_sparse_matrix(Remap_weight_sparse_matrix*);
         void print();
 		Remap_weight_sparse_matrix *gather(int);
+        Remap_weight_sparse_matrix *extract_weights_of_owned_dst_cells(int, long&, long&);
 };
 
 
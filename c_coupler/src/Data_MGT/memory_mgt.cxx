@@ -119,7 +119,7 @@ Field_mem_info::Field_mem_info(const char *field_name, int decomp_id, int comp_o
 			for (int i = 0; i < num_chunks; i ++) {
 				chunks_data_buf_size[i] = decomp_info->get_chunk_size(i)*remap_grid_grid->get_grid_size()/remap_grid_decomp->get_grid_size();
 				if (decomp_info->get_chunk_size(i) > 0) 
-					chunks_buf[i] = new char [chunks_data_buf_size[i]*get_data_type_size(data_type)];
+					chunks_buf[i] = allocate_data_buffer(chunks_data_buf_size[i]*get_data_type_size(data_type));
 				chunk_field_instance_size += chunks_data_buf_size[i]; 
 			}
 		}
@@ -129,8 +129,7 @@ Field_mem_info::Field_mem_info(const char *field_name, int decomp_id, int comp_o
 	    strcpy(remap_data_field->data_type_in_IO_file, data_type);
 	    remap_data_field->required_data_size = mem_size / get_data_type_size(data_type);
 	    if (remap_data_field->required_data_size > 0) {
-	        remap_data_field->data_buf = (char*) (new long [(mem_size+sizeof(long)-1)/sizeof(long)]);
-	        memset(remap_data_field->data_buf, 0, mem_size);
+	        remap_data_field->data_buf = allocate_data_buffer(mem_size);
 	    }
 		if (chunk_field_instance_size > 0)
 			remap_data_field->required_data_size = chunk_field_instance_size;
@@ -160,16 +159,41 @@ Field_mem_info::Field_mem_info(const char *field_name, int decomp_id, int comp_o
 }
 
 
+/* Field data buffers come from the pool of aligned buffers when it is enabled in the performance setting; 
+   otherwise they are zero-initialized buffers of longs as before */
+void *Field_mem_info::allocate_data_buffer(long size)
+{
+    void *buf;
+
+
+    if (field_buffer_pool != NULL)
+        return field_buffer_pool->allocate(size);
+
+    buf = new long [(size+sizeof(long)-1)/sizeof(long)];
+    memset(buf, 0, size);
+    return buf;
+}
+
+
+void Field_mem_info::release_data_buffer(void *buf)
+{
+    if (buf == NULL)
+        return;
+    if (field_buffer_pool == NULL || !field_buffer_pool->release(buf))
+        delete [] (char*) buf;
+}
+
+
 Field_mem_info::~Field_mem_info()
 {
-    if (is_registered_model_buf && num_chunks == 0)
-        grided_field_data->get_grid_data_field()->data_buf = NULL;
+    if (!(is_registered_model_buf && num_chunks == 0))
+        release_data_buffer(grided_field_data->get_grid_data_field()->data_buf);
+    grided_field_data->get_grid_data_field()->data_buf = NULL;
     delete grided_field_data;
 	if (chunks_buf != NULL) {
 		if (!is_registered_model_buf)
 			for (int i = 0; i < num_chunks; i ++)
-				if (chunks_buf[i] != NULL)
-					delete [] chunks_buf[i];
+				release_data_buffer(chunks_buf[i]);
 		delete [] chunks_buf;
 		delete [] chunks_data_buf_size;
 	}
@@ -184,8 +208,7 @@ void Field_mem_info::reset_mem_buf(void * buf, bool is_external_field, int usage
 	}
     EXECUTION_REPORT(REPORT_ERROR, -1, !is_registered_model_buf, "Software error to release a registered buffer");
 
-    if (grided_field_data->get_grid_data_field()->data_buf != NULL)
-        delete [] grided_field_data->get_grid_data_field()->data_buf;
+    release_data_buffer(grided_field_data->get_grid_data_field()->data_buf);
 
     grided_field_data->get_grid_data_field()->data_buf = buf;
 
@@ -202,17 +225,14 @@ void Field_mem_info::reset_mem_buf(Field_mem_info *original_field_mem, int usage
 	if (original_field_mem->num_chunks > 0)
 	    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, original_field_mem->grided_field_data->get_grid_data_field()->data_buf == NULL, "Software error to release a registered buffer");
 
-	if (grided_field_data->get_grid_data_field()->data_buf != NULL) {
-		delete [] grided_field_data->get_grid_data_field()->data_buf;
-		grided_field_data->get_grid_data_field()->data_buf = NULL;
-	}
+	release_data_buffer(grided_field_data->get_grid_data_field()->data_buf);
+	grided_field_data->get_grid_data_field()->data_buf = NULL;
 	this->num_chunks = original_field_mem->num_chunks;
 	this->chunk_field_instance_size = original_field_mem->chunk_field_instance_size;
 	if (this->num_chunks > 0) {
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, this->chunks_buf != NULL, "Software error in Field_mem_info::reset_mem_buf");
 		for (int i = 0; i < num_chunks; i ++) {
-			if (this->chunks_buf[i] != NULL)
-				delete [] this->chunks_buf[i];
+			release_data_buffer(this->chunks_buf[i]);
 			this->chunks_buf[i] = original_field_mem->chunks_buf[i];
 			this->chunks_data_buf_size[i] = original_field_mem->chunks_data_buf_size[i];
 		}
@@ -225,6 +245,8 @@ void Field_mem_info::reset_mem_buf(Field_mem_info *original_field_mem, int usage
 
 void Field_mem_info::change_datatype_to_double()
 {
+    release_data_buffer(grided_field_data->get_grid_data_field()->data_buf);
+    grided_field_data->get_grid_data_field()->data_buf = NULL;
     grided_field_data->change_datatype_in_application(DATA_TYPE_DOUBLE);
 }
 
@@ -443,6 +465,24 @@ long Field_mem_info::calculate_overall_checksum()
 }
 
 
+/* Unlike calculate_overall_checksum, a strong hash of the bytes of the local data, so that it can be used to 
+   decide that the local data has not changed */
+long Field_mem_info::calculate_overall_hash()
+{
+	if (num_chunks == 0)
+		return calculate_hash_of_array((const char*)get_data_buf(), get_size_of_field()*get_data_type_size(get_data_type()));
+
+	long *chunk_hashes = new long [num_chunks], overall_hash;
+	Decomp_info *decomp_info = decomps_info_mgr->get_decomp_info(decomp_id);
+	for (int i = 0; i < num_chunks; i ++)
+		chunk_hashes[i] = calculate_hash_of_array((char*)(chunks_buf[i]), chunk_field_instance_size/decomp_info->get_num_local_cells()*decomp_info->get_chunk_size(i)*get_data_type_size(get_data_type()));
+	overall_hash = calculate_hash_of_array((const char*)chunk_hashes, num_chunks*sizeof(long));
+	delete [] chunk_hashes;
+
+	return overall_hash;
+}
+
+
 bool Field_mem_info::is_checksum_changed()
 {
     if (last_checksum == -1)
@@ -503,7 +543,7 @@ void Field_mem_info::register_a_chunk(void *buf, int field_size, const char *dat
 void Field_mem_info::confirm_overall_data_buf_for_chunks()
 {
 	if (num_chunks > 0 && grided_field_data->get_grid_data_field()->data_buf == NULL && chunk_field_instance_size > 0)
-		grided_field_data->get_grid_data_field()->data_buf = new char [chunk_field_instance_size*get_data_type_size(get_data_type())];	
+		grided_field_data->get_grid_data_field()->data_buf = allocate_data_buffer(chunk_field_instance_size*get_data_type_size(get_data_type()));	
 }
 
 
@@ -532,16 +572,13 @@ void Field_mem_info::transformation_between_chunks_array(bool chunks_to_array)
 void Field_mem_info::change_to_registered_without_data_buffers()
 {
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !is_registered_model_buf, "Software error in Field_mem_info::change_to_registered_without_data_buffers");
-	for (int i = 0; i < num_chunks; i ++)
-		if (chunks_buf[i] != NULL) {
-			delete [] chunks_buf[i];
-			chunks_buf[i] = NULL;
-		}
-		
-	if (grided_field_data->get_grid_data_field()->data_buf != NULL) {
-		delete [] grided_field_data->get_grid_data_field()->data_buf;
-		grided_field_data->get_grid_data_field()->data_buf = NULL;
+	for (int i = 0; i < num_chunks; i ++) {
+		release_data_buffer(chunks_buf[i]);
+		chunks_buf[i] = NULL;
 	}
+		
+	release_data_buffer(grided_field_data->get_grid_data_field()->data_buf);
+	grided_field_data->get_grid_data_field()->data_buf = NULL;
 	
 	is_registered_model_buf = true;
 }
@@ -67,6 +67,9 @@ class Field_mem_info
 		int total_dim_size_before_H2D;
 		int total_dim_size_after_H2D;
 
+		void *allocate_data_buffer(long);
+		void release_data_buffer(void *);
+
     public:
         Field_mem_info(const char *, int, int, int, const char *, const char *, const char *, bool);
         bool match_field_instance(const char *, int, int, int);
@@ -115,6 +118,7 @@ class Field_mem_info
 		int get_chunk_data_buf_size(int i) { return chunks_data_buf_size[i]; }
 		void transformation_between_chunks_array(bool);
 		long calculate_overall_checksum();
+		long calculate_overall_hash();
 		void confirm_overall_data_buf_for_chunks();
 		void change_to_registered_without_data_buffers();
 		void set_data_buf_from_model(void*,int);
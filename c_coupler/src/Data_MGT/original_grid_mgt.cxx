@@ -59,6 +59,7 @@ Original_grid_info::Original_grid_info(int set_comp_id, Original_grid_info *memb
 	if (member_original_grid->interface_level_grid != NULL)
 	    this->interface_level_grid = original_grid_mgr->promote_ensemble_member_grid_to_set(set_comp_id, member_original_grid->interface_level_grid);	
     this->checksum_H2D_mask = member_original_grid->checksum_H2D_mask;
+    this->serialized_grid_size = -1;
     this->used_in_md_grid = member_original_grid->used_in_md_grid;	
 	for (int i = 0; i < member_original_grid->sub_grids_id.size(); i ++)
 		this->sub_grids_id.push_back(original_grid_mgr->promote_ensemble_member_grid_to_set(set_comp_id, original_grid_mgr->search_grid_info(member_original_grid->sub_grids_id[i]))->get_grid_id());
@@ -80,6 +81,7 @@ Original_grid_info::Original_grid_info(int comp_id, int grid_id, const char *gri
     this->interface_level_grid = NULL;
     this->grid_name = strdup(grid_name);
 	this->checksum_H2D_mask = 0;
+    this->serialized_grid_size = -1;
 	this->ensemble_set_grid = NULL;
 	this->ensemble_member_grid = NULL;
     comp_full_name = strdup(comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id, false, "Original_grid_info")->get_full_name());
@@ -276,6 +278,28 @@ void Original_grid_info::write_grid_into_array(char **temp_array_buffer, long &b
 }
 
 
+/* The hash of the array written by write_grid_into_array is kept, so that a grid is serialized only once for all 
+   connections that exchange it. It is computed again when the CoR grid, the mask or the variation types change */
+void Original_grid_info::get_serialized_grid_hash(long &grid_hash, long &grid_size)
+{
+    char *temp_array_buffer = NULL;
+    long buffer_max_size;
+
+
+    if (serialized_grid_size == -1 || hashed_CoR_grid != original_CoR_grid || hashed_checksum_H2D_mask != checksum_H2D_mask || hashed_V3D_lev_field_variation_type != V3D_lev_field_variation_type || hashed_bottom_field_variation_type != bottom_field_variation_type) {
+        write_grid_into_array(&temp_array_buffer, buffer_max_size, serialized_grid_size);
+        serialized_grid_hash = calculate_hash_of_array(temp_array_buffer, serialized_grid_size);
+        delete [] temp_array_buffer;
+        hashed_CoR_grid = original_CoR_grid;
+        hashed_checksum_H2D_mask = checksum_H2D_mask;
+        hashed_V3D_lev_field_variation_type = V3D_lev_field_variation_type;
+        hashed_bottom_field_variation_type = bottom_field_variation_type;
+    }
+    grid_hash = serialized_grid_hash;
+    grid_size = serialized_grid_size;
+}
+
+
 void Original_grid_info::get_grid_data(int decomp_id, int chunk_index, const char *label, const char *data_type, int array_size, char *grid_data, const char *annotation, const char *API_label)
 {
     Remap_grid_data_class *grid_field;
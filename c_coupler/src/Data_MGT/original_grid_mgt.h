@@ -56,6 +56,12 @@ class Original_grid_info
         Original_grid_info *mid_point_grid;
         Original_grid_info *interface_level_grid;
         long checksum_H2D_mask;
+        long serialized_grid_hash;
+        long serialized_grid_size;
+        long hashed_checksum_H2D_mask;
+        int hashed_V3D_lev_field_variation_type;
+        int hashed_bottom_field_variation_type;
+        Remap_grid_class *hashed_CoR_grid;
 		bool used_in_md_grid;
 		std::vector<int> sub_grids_id;
 
@@ -87,6 +93,7 @@ class Original_grid_info
         bool is_V3D_grid() { return H2D_sub_CoR_grid != NULL && V1D_sub_CoR_grid != NULL && Time1D_sub_CoR_grid == NULL; }
         bool is_H2D_grid() { return H2D_sub_CoR_grid != NULL && V1D_sub_CoR_grid == NULL && Time1D_sub_CoR_grid == NULL; } 
         void write_grid_into_array(char **, long &, long &);
+        void get_serialized_grid_hash(long &, long &);
         int get_bottom_field_id();
 		int get_V3D_lev_field_id();
         void get_grid_data(int, int, const char*, const char*, int, char*, const char*, const char*);
@@ -99,6 +99,10 @@ Restart_mgt::Restart_mgt(Comp_comm_group_mgt_node *comp_node)
     last_restart_write_elapsed_time = -1;
     input_restart_mgt_info_file = NULL;
     restart_read_annotation = NULL;
+    pending_restart_read_annotation = NULL;
+    full_checkpoint_data_file_name = NULL;
+    num_restart_writes_since_full_checkpoint = 0;
+    restart_read_full_checkpoint_file_name = NULL;
     restart_mgt_info_written = true;
     time_mgr = NULL;
     restart_write_data_file = NULL;
@@ -117,6 +121,12 @@ Restart_mgt::~Restart_mgt()
         delete [] input_restart_mgt_info_file;
     if (restart_read_annotation != NULL)
         delete [] restart_read_annotation;
+    if (pending_restart_read_annotation != NULL)
+        delete [] pending_restart_read_annotation;
+    if (full_checkpoint_data_file_name != NULL)
+        delete [] full_checkpoint_data_file_name;
+    if (restart_read_full_checkpoint_file_name != NULL)
+        delete [] restart_read_full_checkpoint_file_name;
     if (restart_read_data_file_name != NULL)
         delete restart_read_data_file_name;
     if (backup_restart_write_data_file != NULL)
@@ -199,7 +209,7 @@ void Restart_mgt::read_restart_mgt_info(bool check_existing_data, const char *fi
     int local_proc_id = comp_comm_group_mgt_mgr->get_current_proc_id_in_comp(comp_node->get_comp_id(), "in Restart_mgt::do_restart");
     int temp_int;
     char *array_buffer = NULL;
-    char temp_restart_read_data_file_name[NAME_STR_SIZE*2];
+    char temp_restart_read_data_file_name[NAME_STR_SIZE*2], full_checkpoint_file_name[NAME_STR_SIZE], attribute_type[NAME_STR_SIZE], *dir_end;
     long buffer_content_iter;
 
 
@@ -240,6 +250,17 @@ void Restart_mgt::read_restart_mgt_info(bool check_existing_data, const char *fi
     sprintf(temp_restart_read_data_file_name, "%s.nc", file_name);
     EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), does_file_exist(temp_restart_read_data_file_name), "Error happens when loading the restart data file \"%s\" at the model code with the annotation \"%s\": the file does not exist", temp_restart_read_data_file_name);
     restart_read_data_file_name = strdup(temp_restart_read_data_file_name);
+
+    IO_netcdf *restart_read_data_file = new IO_netcdf(restart_read_data_file_name, restart_read_data_file_name, "r", false);
+    if (restart_read_data_file->get_file_field_string_attribute(NULL, "full_checkpoint_file", full_checkpoint_file_name, attribute_type, comp_node->get_comm_group(), local_proc_id == 0)) {
+        dir_end = strrchr(temp_restart_read_data_file_name, '/');
+        if (dir_end != NULL)
+            sprintf(dir_end+1, "%s", full_checkpoint_file_name);
+        else strcpy(temp_restart_read_data_file_name, full_checkpoint_file_name);
+        EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), does_file_exist(temp_restart_read_data_file_name), "Error happens when loading the restart data file \"%s\" at the model code with the annotation \"%s\": it is an incremental restart data file, while the corresponding full checkpoint file \"%s\" does not exist", restart_read_data_file_name, annotation, temp_restart_read_data_file_name);
+        restart_read_full_checkpoint_file_name = strdup(temp_restart_read_data_file_name);
+    }
+    delete restart_read_data_file;
 }
 
 
@@ -249,6 +270,7 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
     const char *comp_full_name = comp_node->get_full_name();
     long current_full_time;
     Restart_buffer_container *time_mgr_restart_buffer;
+    bool is_full_checkpoint;
 
 
     bypass_import_fields_at_write = bypass_imported_fields;
@@ -269,6 +291,16 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
         last_restart_write_elapsed_time = time_mgr->get_current_num_elapsed_day()*((long)100000)+time_mgr->get_current_second();
         int date = last_restart_write_full_time/(long)100000;
         int second = last_restart_write_full_time%(long)100000;
+        is_full_checkpoint = incremental_restart_interval <= 1 || full_checkpoint_data_file_name == NULL || num_restart_writes_since_full_checkpoint >= incremental_restart_interval;
+        if (is_full_checkpoint) {
+            if (full_checkpoint_data_file_name != NULL)
+                delete [] full_checkpoint_data_file_name;
+            full_checkpoint_data_file_name = new char [NAME_STR_SIZE];
+            sprintf(full_checkpoint_data_file_name, "%s.%s.r.%08d-%05d.nc", time_mgr->get_case_name(), comp_node->get_comp_full_name(), date, second);
+            full_checkpoint_field_hashes.clear();
+            num_restart_writes_since_full_checkpoint = 0;
+        }
+        num_restart_writes_since_full_checkpoint ++;
         if (local_proc_id == 0) {
             EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), restart_write_data_file == NULL, "Error happens when the component model tries to write restart data files: restart writing is too frequent so that a new restart writing starts before the previous restart writing does not finish. Please verify the model code with the annotation \"%s\"", annotation);
             time_mgr_restart_buffer = apply_restart_buffer(comp_full_name, RESTART_BUF_TYPE_TIME, "local time manager");
@@ -280,27 +312,59 @@ void Restart_mgt::do_restart_write(const char *annotation, bool bypass_timer, bo
                 backup_restart_write_data_file = NULL;
             }
             restart_write_data_file = new IO_netcdf(restart_data_file_name, restart_data_file_name, "w", false);
+            if (!is_full_checkpoint)
+                restart_write_data_file->put_global_attr("full_checkpoint_file", full_checkpoint_data_file_name, DATA_TYPE_STRING, DATA_TYPE_STRING, -1);
             sprintf(restart_data_file_name, "%s/restart/%s.%s.r.%08d-%05d", comp_node->get_working_dir(), time_mgr->get_case_name(), comp_node->get_comp_full_name(), date, second);
             FILE *restart_mgt_info_file = fopen(restart_data_file_name, "w+");
             fclose(restart_mgt_info_file);
         }
         inout_interface_mgr->write_into_restart_buffers(comp_node->get_comp_id());
         restart_mgt_info_written = false;
+        read_all_pending_restarted_fields();
         for (int i = 0; i < restarted_field_instances.size(); i ++) {
-            if (!bypass_imported_fields)
-                write_restart_field_data(restarted_field_instances[i].first, NULL, NULL, false);
-            else if (!restarted_field_instances[i].second)
+            if (bypass_imported_fields && restarted_field_instances[i].second)
+                continue;
+            if (!is_restarted_field_unchanged(restarted_field_instances[i].first, is_full_checkpoint))
                 write_restart_field_data(restarted_field_instances[i].first, NULL, NULL, false);
         }
     }
 }
 
 
-void Restart_mgt::get_field_IO_name(char *field_IO_name, Field_mem_info *field_instance, const char *interface_name, const char*label, bool use_time_info)
+/* In an incremental restart writing, a restarted field is not written when its content 
+   is the same on all processes as at the last full checkpoint, and will be read from 
+   the full checkpoint file instead. Each process records the strong hash of its local 
+   data at each full checkpoint, and the field is unchanged only when no process finds 
+   a different hash. No hash is computed when incremental restart writing is disabled */
+bool Restart_mgt::is_restarted_field_unchanged(Field_mem_info *field_instance, bool is_full_checkpoint)
 {
-    Field_mem_info *global_field = fields_gather_scatter_mgr->gather_field(field_instance);
+    long hash_value;
+    std::map<Field_mem_info*, long>::iterator iter;
+    int local_changed, changed;
 
 
+    if (incremental_restart_interval <= 1)
+        return false;
+
+    hash_value = field_instance->calculate_overall_hash();
+    if (is_full_checkpoint) {
+        full_checkpoint_field_hashes[field_instance] = hash_value;
+        return false;
+    }
+
+    iter = full_checkpoint_field_hashes.find(field_instance);
+    local_changed = (iter == full_checkpoint_field_hashes.end() || iter->second != hash_value)? 1 : 0;
+    MPI_Allreduce(&local_changed, &changed, 1, MPI_INT, MPI_MAX, comp_node->get_comm_group());
+    if (changed == 1)
+        return false;
+
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_node->get_comp_id(), true, "Does not write the unchanged restart field \"%s\", which is in the full checkpoint file \"%s\"", field_instance->get_field_name(), full_checkpoint_data_file_name);
+    return true;
+}
+
+
+void Restart_mgt::get_field_IO_name(char *field_IO_name, Field_mem_info *field_instance, const char *interface_name, const char*label, bool use_time_info)
+{
     if (interface_name != NULL) {
         if (use_time_info)
             sprintf(field_IO_name, "%s.%s.%s.%13ld", field_instance->get_field_name(), interface_name, label, time_mgr->get_current_full_time());
@@ -352,7 +416,34 @@ void Restart_mgt::read_all_restarted_fields(const char *annotation)
     EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), restart_normal_fields_enabled, "Error happens when calling the API \"CCPL_restart_read_fields_all\" to read restart fields: some import interfaces have been executed without bypassing the timer, which is not allowed. Please verify the model code corresponding to the annotation \"%s\"", annotation);
 
     for (int i = 0; i < restarted_field_instances.size(); i ++)
-        read_restart_field_data(restarted_field_instances[i].first, NULL, NULL, false, NULL, bypass_import_fields_at_read&&restarted_field_instances[i].second, annotation);
+        if (lazy_restart_read > 0 && restarted_field_instances[i].second && is_import_interface_field(restarted_field_instances[i].first))
+            pending_restarted_field_instances.push_back(restarted_field_instances[i].first);
+        else read_restart_field_data(restarted_field_instances[i].first, NULL, NULL, false, NULL, bypass_import_fields_at_read&&restarted_field_instances[i].second, annotation);
+
+    if (pending_restarted_field_instances.size() > 0) {
+        pending_restart_read_annotation = strdup(annotation);
+        EXECUTION_REPORT_LOG(REPORT_LOG, comp_node->get_comp_id(), true, "Defer reading %d restart fields of import interfaces from the file \"%s\" at the model code with the annotation \"%s\"", pending_restarted_field_instances.size(), restart_read_data_file_name, annotation);
+    }
+}
+
+
+/* A restart field of an import interface that is deferred by read_all_restarted_fields 
+   is read at its first use: when an interface with this field is executed or when 
+   restart data is written. The reading is collective among the processes of the component */
+void Restart_mgt::read_pending_restarted_field(Field_mem_info *field_instance)
+{
+    for (int i = 0; i < pending_restarted_field_instances.size(); i ++)
+        if (pending_restarted_field_instances[i] == field_instance) {
+            read_restart_field_data(field_instance, NULL, NULL, false, NULL, bypass_import_fields_at_read, pending_restart_read_annotation);
+            return;
+        }
+}
+
+
+void Restart_mgt::read_all_pending_restarted_fields()
+{
+    while (pending_restarted_field_instances.size() > 0)
+        read_restart_field_data(pending_restarted_field_instances[0], NULL, NULL, false, NULL, bypass_import_fields_at_read, pending_restart_read_annotation);
 }
 
 
@@ -361,6 +452,12 @@ void Restart_mgt::read_restart_field_data(Field_mem_info *field_instance, const
     char field_IO_name[NAME_STR_SIZE*2], hint[NAME_STR_SIZE*2];
 
         
+    for (int i = 0; i < pending_restarted_field_instances.size(); i ++)
+        if (pending_restarted_field_instances[i] == field_instance) {
+            pending_restarted_field_instances.erase(pending_restarted_field_instances.begin()+i);
+            break;
+        }
+
     get_field_IO_name(field_IO_name, field_instance, interface_name, label, use_time_info);
 
     if (interface_name == NULL && !field_instance->is_checksum_changed()) {
@@ -375,6 +472,12 @@ void Restart_mgt::read_restart_field_data(Field_mem_info *field_instance, const
     IO_netcdf *restart_read_data_file = new IO_netcdf(restart_read_data_file_name, restart_read_data_file_name, "r", false);
     bool has_data_in_file = fields_gather_scatter_mgr->read_scatter_field(restart_read_data_file, field_instance, field_IO_name, -1, false);
     delete restart_read_data_file;
+    if (!has_data_in_file && interface_name == NULL && restart_read_full_checkpoint_file_name != NULL) {
+        EXECUTION_REPORT_LOG(REPORT_LOG, comp_node->get_comp_id(), true, "Read restart field \"%s\" from the full checkpoint file \"%s\"", field_IO_name, restart_read_full_checkpoint_file_name);
+        restart_read_data_file = new IO_netcdf(restart_read_full_checkpoint_file_name, restart_read_full_checkpoint_file_name, "r", false);
+        has_data_in_file = fields_gather_scatter_mgr->read_scatter_field(restart_read_data_file, field_instance, field_IO_name, -1, false);
+        delete restart_read_data_file;
+    }
     if (!optional && (time_mgr->get_runtype_mark() == RUNTYPE_MARK_CONTINUE || time_mgr->get_runtype_mark() == RUNTYPE_MARK_BRANCH))
         if (interface_name != NULL)
             EXECUTION_REPORT(REPORT_ERROR, comp_node->get_comp_id(), has_data_in_file, "Error happens when loading the restart data file \"%s\" at the model code with the annotation \"%s\": the data file does not contain the variable \"%s\" for the field \"%s\" of the coupling interface \"%s\"", restart_read_data_file_name, annotation, field_IO_name, field_instance->get_field_name(), interface_name);
@@ -514,8 +617,11 @@ bool Restart_mgt::is_in_restart_read_window(long full_time)
 }
 
 
-void Restart_mgt::add_restarted_field_instance(Field_mem_info *field_instance, bool is_imported_field)
+void Restart_mgt::add_restarted_field_instance(Field_mem_info *field_instance, bool is_imported_field, bool from_import_interface)
 {
+    if (from_import_interface && !is_import_interface_field(field_instance))
+        import_interface_field_instances.push_back(field_instance);
+
     for (int i = 0; i < restarted_field_instances.size(); i ++)
         if (restarted_field_instances[i].first == field_instance) {
             if (!is_imported_field)
@@ -527,6 +633,18 @@ void Restart_mgt::add_restarted_field_instance(Field_mem_info *field_instance, b
 }
 
 
+/* Only the restart fields of import interfaces can be deferred by lazy_restart_read, because the execution of the 
+   interfaces is where they are read. Other imported fields, such as the bottom fields of 3-D grids, are read eagerly */
+bool Restart_mgt::is_import_interface_field(Field_mem_info *field_instance)
+{
+    for (int i = 0; i < import_interface_field_instances.size(); i ++)
+        if (import_interface_field_instances[i] == field_instance)
+            return true;
+
+    return false;
+}
+
+
 bool Restart_mgt::check_restart_read_started()
 {
     return input_restart_mgt_info_file != NULL;
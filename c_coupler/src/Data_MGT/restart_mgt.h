@@ -20,6 +20,7 @@
 #include "io_netcdf.h"
 #include "memory_mgt.h"
 #include <vector>
+#include <map>
 
 
 class Restart_mgt;
@@ -66,6 +67,13 @@ class Restart_mgt
         std::vector<Restart_buffer_container*> restart_write_buffer_containers;
         std::vector<Restart_buffer_container*> restart_read_buffer_containers;
         std::vector<std::pair<Field_mem_info*, bool> > restarted_field_instances;
+        std::vector<Field_mem_info*> import_interface_field_instances;
+        std::vector<Field_mem_info*> pending_restarted_field_instances;
+        char *pending_restart_read_annotation;
+        std::map<Field_mem_info*, long> full_checkpoint_field_hashes;
+        char *full_checkpoint_data_file_name;
+        int num_restart_writes_since_full_checkpoint;
+        char *restart_read_full_checkpoint_file_name;
         Comp_comm_group_mgt_node *comp_node;
         Time_mgt *time_mgr;
         char *input_restart_mgt_info_file;
@@ -79,6 +87,8 @@ class Restart_mgt
         bool bypass_import_fields_at_read;
         bool bypass_import_fields_at_write;
 
+        bool is_restarted_field_unchanged(Field_mem_info*, bool);
+
     public:
         Restart_mgt(Comp_comm_group_mgt_node*);
         ~Restart_mgt();
@@ -98,9 +108,12 @@ class Restart_mgt
         void write_restart_field_data(Field_mem_info *, const char*, const char*, bool);
         void read_restart_field_data(Field_mem_info *, const char *, const char *, bool, const char *, bool, const char*);
         const char *get_restart_read_data_file_name() { return restart_read_data_file_name; }
-        void add_restarted_field_instance(Field_mem_info*, bool);
+        void add_restarted_field_instance(Field_mem_info*, bool, bool);
+        bool is_import_interface_field(Field_mem_info*);
         void get_field_IO_name(char *, Field_mem_info*, const char *, const char*, bool);
         void read_all_restarted_fields(const char*);
+        void read_pending_restarted_field(Field_mem_info*);
+        void read_all_pending_restarted_fields();
         bool check_restart_read_started();
         bool get_are_all_restarted_fields_read() { return are_all_restarted_fields_read; }
         bool get_bypass_import_fields_at_read() { return bypass_import_fields_at_read; }
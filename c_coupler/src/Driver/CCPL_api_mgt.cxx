@@ -10,6 +10,7 @@
 #include "CCPL_api_mgt.h"
 #include "global_data.h"
 #include <unistd.h>
+#include <string.h>
 #include "quick_sort.h"
 
 
@@ -33,6 +34,32 @@ long calculate_checksum_of_array(const char *data_array, int array_size, int dat
 }
 
 
+/* Unlike calculate_checksum_of_array, which is a weighted sum, this hash mixes every word of the array, so that 
+    it can be used to decide whether two arrays have the same content */
+long calculate_hash_of_array(const char *data_array, long array_size)
+{
+    unsigned long hash_value = 0xcbf29ce484222325UL ^ (unsigned long) array_size, word;
+    long i;
+
+
+    for (i = 0; i + (long) sizeof(unsigned long) <= array_size; i += sizeof(unsigned long)) {
+        memcpy(&word, data_array+i, sizeof(unsigned long));
+        word *= 0x87c37b91114253d5UL;
+        word ^= word >> 31;
+        word *= 0x4cf5ad432745937fUL;
+        hash_value = (hash_value ^ word) * 0x100000001b3UL;
+        hash_value ^= hash_value >> 29;
+    }
+    for (; i < array_size; i ++)
+        hash_value = (hash_value ^ (unsigned char) data_array[i]) * 0x100000001b3UL;
+    hash_value ^= hash_value >> 33;
+    hash_value *= 0xff51afd7ed558ccdUL;
+    hash_value ^= hash_value >> 33;
+
+    return (long) hash_value;
+}
+
+
 void get_API_hint(int comp_id, int API_id, char *API_label)
 {
     switch(API_id) {
@@ -84,6 +84,9 @@ extern "C" void finalize_ccpl_
     delete fields_info;
     delete original_grid_mgr;
     delete memory_manager;
+    if (field_buffer_pool != NULL)
+        delete field_buffer_pool;
+    field_buffer_pool = NULL;
     delete coupling_generator;
     delete comp_comm_group_mgt_mgr;
     comp_comm_group_mgt_mgr = NULL;
@@ -397,8 +400,11 @@ int *enabled_in_parent_coupling_gen, int *change_dir, const char *executable_nam
 
     comp_comm_group_mgt_mgr = new Comp_comm_group_mgt_mgr(executable_name);
     import_report_setting();
-	
-	cpp_comm = MPI_Comm_f2c(*f_comm);
+    import_performance_setting();
+    if (pooled_field_buffers > 0)
+        field_buffer_pool = new Aligned_buffer_pool(huge_page_field_buffers > 0);
+
+    cpp_comm = MPI_Comm_f2c(*f_comm);
     if (cpp_comm != MPI_COMM_NULL) {
         EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Before MPI_barrier at root component \"%s\" for synchronizing the processes of the component (the corresponding model code annotation is \"%s\").", comp_name, annotation);
         EXECUTION_REPORT(REPORT_ERROR,-1, MPI_Barrier(cpp_comm) == MPI_SUCCESS);
@@ -953,7 +959,7 @@ extern "C" void set_3d_grid_surface_field_
     check_for_coupling_registration_stage(comp_id, API_id, true, annotation);
     original_grid_mgr->set_3d_grid_bottom_field(comp_id, *grid_id, *field_id, *static_or_dynamic_or_external, API_id, API_label, annotation);
     if (*static_or_dynamic_or_external != BOTTOM_FIELD_VARIATION_EXTERNAL)
-        comp_comm_group_mgt_mgr->search_global_node(comp_id)->get_restart_mgr()->add_restarted_field_instance(memory_manager->get_field_instance(*field_id), true);
+        comp_comm_group_mgt_mgr->search_global_node(comp_id)->get_restart_mgr()->add_restarted_field_instance(memory_manager->get_field_instance(*field_id), true, false);
 
     EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish to setting surface field for the 3D grid %s", original_grid_mgr->get_name_of_grid(*grid_id));
 }
@@ -1418,7 +1424,7 @@ extern "C" void finish_ccpl_chunk_field_instance_registration_
 	Field_mem_info *field_instance = memory_manager->get_field_instance(*field_instance_id);
 	field_instance->finish_chunk_registration(annotation);	
     if (field_instance->is_REST_field_inst())
-        comp_comm_group_mgt_mgr->search_global_node(field_instance->get_host_comp_id())->get_restart_mgr()->add_restarted_field_instance(field_instance, false);
+        comp_comm_group_mgt_mgr->search_global_node(field_instance->get_host_comp_id())->get_restart_mgr()->add_restarted_field_instance(field_instance, false, false);
 	EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish finishing registration of a chunk field instance");
 }
 
@@ -1437,7 +1443,7 @@ extern "C" void register_external_field_instance_
     *field_instance_id = memory_manager->register_external_field_instance(field_name, (void*)(*data_buffer_ptr), *field_size, *decomp_id, *comp_or_grid_id, *buf_mark, *usage_tag, unit, data_type, annotation);
     Field_mem_info *field_instance = memory_manager->get_field_instance(*field_instance_id);
     if (field_instance->is_REST_field_inst())
-        comp_comm_group_mgt_mgr->search_global_node(field_instance->get_host_comp_id())->get_restart_mgr()->add_restarted_field_instance(field_instance, false);
+        comp_comm_group_mgt_mgr->search_global_node(field_instance->get_host_comp_id())->get_restart_mgr()->add_restarted_field_instance(field_instance, false, false);
     
     EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "Finish registering a normal field instance %s", field_name);
 }
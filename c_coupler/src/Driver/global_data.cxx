@@ -21,6 +21,7 @@ Time_mgt *restart_read_timer_mgr = NULL;
 Decomp_info_mgt *decomps_info_mgr = NULL;
 Field_info_mgt *fields_info = NULL;
 Memory_mgt *memory_manager = NULL;
+Aligned_buffer_pool *field_buffer_pool = NULL;
 Remap_mgt *grid_remap_mgr = NULL;
 Fields_gather_scatter_mgt *fields_gather_scatter_mgr = NULL;
 Decomp_grid_mgt *decomp_grids_mgr = NULL;
@@ -22,6 +22,8 @@
 #include "decomp_grid_mgt.h"
 #include "common_utils.h"
 #include "execution_report.h"
+#include "performance_setting.h"
+#include "memory_pool.h"
 #include "performance_timing_mgt.h"
 #include "ensemble_mgt.h"
 #include "object_type_prefix.h"
@@ -51,6 +53,7 @@ extern Time_mgt *restart_read_timer_mgr;
 extern Decomp_info_mgt *decomps_info_mgr;
 extern Field_info_mgt *fields_info;
 extern Memory_mgt *memory_manager;
+extern Aligned_buffer_pool *field_buffer_pool;
 extern Remap_mgt *grid_remap_mgr;
 extern Fields_gather_scatter_mgt *fields_gather_scatter_mgr;
 extern Decomp_grid_mgt *decomp_grids_mgr;
@@ -22,6 +22,37 @@ int num_days_of_month_of_nonleap_year[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 3
 int num_days_of_month_of_leap_year[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
 
+#define NUM_YEARS_PER_GREGORIAN_CYCLE   ((long)400)
+#define NUM_DAYS_PER_GREGORIAN_CYCLE    ((long)146097)
+
+
+static bool calendar_tables_initialized = false;
+static long elapsed_days_on_start_of_year_in_gregorian_cycle[NUM_YEARS_PER_GREGORIAN_CYCLE+1];
+static int month_of_day_in_nonleap_year[NUM_DAYS_PER_NONLEAP_YEAR];
+static int month_of_day_in_leap_year[NUM_DAYS_PER_LEAP_YEAR];
+
+
+static void initialize_calendar_tables()
+{
+    int i, j, k;
+
+
+    if (calendar_tables_initialized)
+        return;
+
+    elapsed_days_on_start_of_year_in_gregorian_cycle[0] = 0;
+    for (i = 0; i < NUM_YEARS_PER_GREGORIAN_CYCLE; i ++)
+        elapsed_days_on_start_of_year_in_gregorian_cycle[i+1] = elapsed_days_on_start_of_year_in_gregorian_cycle[i] + (((i%4) == 0 && (i%100) != 0) || (i%400) == 0? NUM_DAYS_PER_LEAP_YEAR : NUM_DAYS_PER_NONLEAP_YEAR);
+    for (i = 0, k = 0; i < NUM_MONTH_PER_YEAR; i ++)
+        for (j = 0; j < num_days_of_month_of_nonleap_year[i]; j ++)
+            month_of_day_in_nonleap_year[k++] = i + 1;
+    for (i = 0, k = 0; i < NUM_MONTH_PER_YEAR; i ++)
+        for (j = 0; j < num_days_of_month_of_leap_year[i]; j ++)
+            month_of_day_in_leap_year[k++] = i + 1;
+    calendar_tables_initialized = true;
+}
+
+
 bool common_is_timer_on(const char *frequency_unit, int frequency_count, int local_lag_count, int current_year, 
                       int current_month, int current_day, int current_second, int current_num_elapsed_day,
                       int start_year, int start_month, int start_day, int start_second, int start_num_elapsed_day)
@@ -159,11 +190,85 @@ bool Coupling_timer::is_timer_on(int current_year, int current_month, int curren
 }
 
 
+/* Computes in closed form the time (in seconds since the calendar origin) when the timer is on for the first time 
+   not earlier than (forward) or for the last time not later than (backward) the given time step. Returns false 
+   when the closed form does not apply (e.g., the timer has children or its on times are not on the time steps),
+   so that the caller should search step by step. The result is -1 when no such time exists in the backward case. */
+bool Coupling_timer::get_closest_timer_on_time(Time_mgt *time_mgr, long current_time, int current_year, int current_month, int current_day, int time_step_in_second, bool forward, long &timer_on_time)
+{
+    long period_start_time, period_length, num_periods, num_elapsed_units;
+    bool at_period_start;
+
+
+    if (children.size() > 0 || frequency_count <= 0 || time_step_in_second <= 0)
+        return false;
+
+    if (IS_TIME_UNIT_SECOND(frequency_unit) || IS_TIME_UNIT_DAY(frequency_unit)) {
+        if (IS_TIME_UNIT_SECOND(frequency_unit)) {
+            period_start_time = ((long)time_mgr->get_start_num_elapsed_day())*SECONDS_PER_DAY + time_mgr->get_start_second() + local_lag_count;
+            period_length = frequency_count;
+        }
+        else {
+            period_start_time = ((long)time_mgr->get_start_num_elapsed_day() + local_lag_count)*SECONDS_PER_DAY;
+            period_length = ((long)frequency_count)*SECONDS_PER_DAY;
+        }
+        if (period_length % time_step_in_second != 0 || (current_time-period_start_time) % time_step_in_second != 0)
+            return false;
+        if (current_time < period_start_time) {
+            timer_on_time = forward? period_start_time : -1;
+            return true;
+        }
+        num_periods = (current_time-period_start_time) / period_length;
+        if (forward && (current_time-period_start_time) % period_length != 0)
+            num_periods ++;
+        timer_on_time = period_start_time + num_periods*period_length;
+        return true;
+    }
+
+    if (!IS_TIME_UNIT_MONTH(frequency_unit) && !IS_TIME_UNIT_YEAR(frequency_unit))
+        return false;
+    if (SECONDS_PER_DAY % time_step_in_second != 0 || current_time % time_step_in_second != 0 || local_lag_count < 0)
+        return false;
+    if (IS_TIME_UNIT_MONTH(frequency_unit)) {
+        num_elapsed_units = (current_year-time_mgr->get_start_year())*NUM_MONTH_PER_YEAR + current_month - time_mgr->get_start_month();
+        at_period_start = current_day == 1 && current_time % SECONDS_PER_DAY == 0;
+    }
+    else {
+        num_elapsed_units = current_year - time_mgr->get_start_year();
+        at_period_start = current_month == 1 && current_day == 1 && current_time % SECONDS_PER_DAY == 0;
+    }
+    if (forward && !at_period_start)
+        num_elapsed_units ++;
+    if (num_elapsed_units < local_lag_count) {
+        if (!forward) {
+            timer_on_time = -1;
+            return true;
+        }
+        num_elapsed_units = local_lag_count;
+    }
+    num_periods = (num_elapsed_units-local_lag_count) / frequency_count;
+    if (forward && (num_elapsed_units-local_lag_count) % frequency_count != 0)
+        num_periods ++;
+    num_elapsed_units = local_lag_count + num_periods*frequency_count;
+    if (IS_TIME_UNIT_MONTH(frequency_unit))
+        timer_on_time = time_mgr->calculate_elapsed_day(time_mgr->get_start_year()+(time_mgr->get_start_month()-1+num_elapsed_units)/NUM_MONTH_PER_YEAR, (time_mgr->get_start_month()-1+num_elapsed_units)%NUM_MONTH_PER_YEAR+1, 1) * SECONDS_PER_DAY;
+    else timer_on_time = time_mgr->calculate_elapsed_day(time_mgr->get_start_year()+num_elapsed_units, 1, 1) * SECONDS_PER_DAY;
+
+    return true;
+}
+
+
 void Coupling_timer::get_time_of_next_timer_on(Time_mgt *time_mgr, int current_year, int current_month, int current_day, int current_second, int current_num_elapsed_days, int time_step_in_second, int &next_timer_num_elapsed_days, int &next_timer_date, int &next_timer_second, bool advance)
 {    
+    long current_time, next_timer_time;
+
+
     if (advance)
         time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
-    while (!is_timer_on(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_mgr->get_start_year(), 
+    current_time = ((long)current_num_elapsed_days)*SECONDS_PER_DAY + current_second;
+    if (get_closest_timer_on_time(time_mgr, current_time, current_year, current_month, current_day, time_step_in_second, true, next_timer_time))
+        time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, next_timer_time-current_time);
+    else while (!is_timer_on(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_mgr->get_start_year(), 
                         time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day()))    
         time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
 
@@ -602,23 +707,55 @@ int Time_mgt::get_current_num_days_in_year()
 
 long Time_mgt::calculate_elapsed_day(int year, int month, int day)
 {
-    int num_leap_year;
+    check_is_time_legal(year, month, day, 0, "(at calculate_elapsed_day)");
 
+    return calculate_elapsed_day_of_legal_date(year, month, day);
+}
 
-    check_is_time_legal(year, month, day, 0, "(at calculate_elapsed_day)");
 
+/* year 0 is a leap year, so that the Gregorian calendar repeats every 400 years from the year 0 */
+long Time_mgt::calculate_elapsed_day_of_legal_date(int year, int month, int day)
+{
     if (!leap_year_on)
         return year*NUM_DAYS_PER_NONLEAP_YEAR + elapsed_days_on_start_of_month_of_nonleap_year[month-1] + day - 1;
 
-    num_leap_year = (year-1)/4 - (year-1)/100 + (year-1)/400;
+    initialize_calendar_tables();
+    if (is_a_leap_year(year))
+        return (year/NUM_YEARS_PER_GREGORIAN_CYCLE)*NUM_DAYS_PER_GREGORIAN_CYCLE + elapsed_days_on_start_of_year_in_gregorian_cycle[year%NUM_YEARS_PER_GREGORIAN_CYCLE] + elapsed_days_on_start_of_month_of_leap_year[month-1] + day - 1;
+
+    return (year/NUM_YEARS_PER_GREGORIAN_CYCLE)*NUM_DAYS_PER_GREGORIAN_CYCLE + elapsed_days_on_start_of_year_in_gregorian_cycle[year%NUM_YEARS_PER_GREGORIAN_CYCLE] + elapsed_days_on_start_of_month_of_nonleap_year[month-1] + day - 1;
+}
 
-    if (year > 0)
-        num_leap_year ++;   // year 0 is a leap year
 
-    if (is_a_leap_year(year))
-        return year*NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_leap_year[month-1] + day - 1;
+void Time_mgt::get_date_from_elapsed_day(long num_elapsed_day, int &year, int &month, int &day)
+{
+    long day_in_year, day_in_cycle;
+
+
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, comp_id, num_elapsed_day >= 0, "Software error in Time_mgt::get_date_from_elapsed_day: negative number of elapsed days");
+    initialize_calendar_tables();
+    if (!leap_year_on) {
+        year = num_elapsed_day / NUM_DAYS_PER_NONLEAP_YEAR;
+        day_in_year = num_elapsed_day % NUM_DAYS_PER_NONLEAP_YEAR;
+        month = month_of_day_in_nonleap_year[day_in_year];
+        day = day_in_year - elapsed_days_on_start_of_month_of_nonleap_year[month-1] + 1;
+        return;
+    }
 
-    return year*NUM_DAYS_PER_NONLEAP_YEAR + num_leap_year + elapsed_days_on_start_of_month_of_nonleap_year[month-1] + day - 1;
+    day_in_cycle = num_elapsed_day % NUM_DAYS_PER_GREGORIAN_CYCLE;
+    year = day_in_cycle / NUM_DAYS_PER_LEAP_YEAR;
+    if (elapsed_days_on_start_of_year_in_gregorian_cycle[year+1] <= day_in_cycle)
+        year ++;
+    day_in_year = day_in_cycle - elapsed_days_on_start_of_year_in_gregorian_cycle[year];
+    year += (num_elapsed_day / NUM_DAYS_PER_GREGORIAN_CYCLE) * NUM_YEARS_PER_GREGORIAN_CYCLE;
+    if (is_a_leap_year(year)) {
+        month = month_of_day_in_leap_year[day_in_year];
+        day = day_in_year - elapsed_days_on_start_of_month_of_leap_year[month-1] + 1;
+    }
+    else {
+        month = month_of_day_in_nonleap_year[day_in_year];
+        day = day_in_year - elapsed_days_on_start_of_month_of_nonleap_year[month-1] + 1;
+    }
 }
 
 
@@ -632,30 +769,20 @@ long Time_mgt::get_elapsed_day_from_full_time(long full_time)
 }
 
 
-void Time_mgt::advance_time(int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, int time_step_in_second)
+void Time_mgt::advance_time(int &current_year, int &current_month, int &current_day, int &current_second, int &current_num_elapsed_day, long time_step_in_second)
 {
-    int i, num_days_in_current_month;
+    long num_seconds, num_days;
 
 
     if (&current_year == &(this->current_year))
         time_has_been_advanced = true;
-    current_second += time_step_in_second;
-    for (i = 0; i < current_second / SECONDS_PER_DAY; i ++) {
-        current_num_elapsed_day ++;
-        if (leap_year_on && is_a_leap_year(current_year)) 
-            num_days_in_current_month = num_days_of_month_of_leap_year[current_month-1];
-        else num_days_in_current_month = num_days_of_month_of_nonleap_year[current_month-1];
-        current_day ++;
-        if (current_day > num_days_in_current_month) {
-            current_month ++;
-            current_day = 1;
-        }
-        if (current_month > 12) {
-            current_month = 1;
-            current_year ++;
-        }
+    num_seconds = current_second + time_step_in_second;
+    num_days = num_seconds / SECONDS_PER_DAY;
+    if (num_days > 0) {
+        current_num_elapsed_day += num_days;
+        get_date_from_elapsed_day(calculate_elapsed_day_of_legal_date(current_year, current_month, current_day)+num_days, current_year, current_month, current_day);
     }
-    current_second = current_second % SECONDS_PER_DAY;    
+    current_second = num_seconds % SECONDS_PER_DAY;    
 }
 
 
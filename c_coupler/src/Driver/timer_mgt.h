@@ -111,6 +111,7 @@ class Coupling_timer
         const char *get_frequency_unit() { return frequency_unit; }
         void write_timer_into_array(char **, long &, long &);
         void get_time_of_next_timer_on(Time_mgt *, int, int, int, int, int, int, int &, int &, int &, bool);
+        bool get_closest_timer_on_time(Time_mgt *, long, int, int, int, int, bool, long &);
         void reset_remote_lag_count() { remote_lag_count = 0; }
         void check_timer_format();
         bool is_the_same_with(Coupling_timer *);
@@ -193,7 +194,7 @@ class Time_mgt
         ~Time_mgt();
         void initialize_to_start_time();
         void advance_model_time(const char*, bool);
-        void advance_time(int &, int &, int &, int &, int &, int);
+        void advance_time(int &, int &, int &, int &, int &, long);
         int get_current_year() { return current_year; }
         int get_current_month() { return current_month; }
         int get_current_day() { return current_day; }
@@ -226,6 +227,8 @@ class Time_mgt
         void check_timer_format(const char*, int, int, int, bool, const char*);
         bool check_time_consistency_between_components(long);
         long calculate_elapsed_day(int, int, int);
+        long calculate_elapsed_day_of_legal_date(int, int, int);
+        void get_date_from_elapsed_day(long, int &, int &, int &);
 		long get_elapsed_day_from_full_time(long);
         void get_elapsed_days_from_start_date(int*, int*);
         void get_elapsed_days_from_reference_date(int*, int*);
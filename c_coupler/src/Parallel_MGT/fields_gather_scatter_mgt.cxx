@@ -10,6 +10,7 @@
 #include <mpi.h>
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
 #include "fields_gather_scatter_mgt.h"
 #include "global_data.h"
 
@@ -60,6 +61,39 @@ template <class T> void Gather_scatter_rearrange_info::rearrange_scatter_data(T
 }
 
 
+template <class T> void Gather_scatter_rearrange_info::rearrange_output_data(T *buf_src, T *buf_dst)
+{
+    long i, j, k;
+    T *tmp_buf_src;
+
+
+    for (k = 0; k < num_levels; k ++)
+        for (i = 0; i < num_output_sorted_cells; i ++) {
+            tmp_buf_src = buf_src + output_sorted_cells_src_offset[i] + k*output_sorted_cells_level_stride[i];
+            for (j = 0; j < num_points_in_each_cell; j ++)
+                *(buf_dst++) = tmp_buf_src[j];
+        }
+}
+
+
+template <class T> void Gather_scatter_rearrange_info::rearrange_input_data(T *buf_src, T *buf_dst)
+{
+    long i, j, k;
+    T *tmp_buf_src, *tmp_buf_dst;
+
+
+    for (k = 0; k < num_levels; k ++)
+        for (i = 0; i < num_input_local_cells; i ++) {
+            if (input_cells_sorted_position[i] == -1)
+                continue;
+            tmp_buf_src = buf_src + (k*num_input_sorted_cells + input_cells_sorted_position[i])*num_points_in_each_cell;
+            tmp_buf_dst = buf_dst + (k*num_input_local_cells + i)*num_points_in_each_cell;
+            for (j = 0; j < num_points_in_each_cell; j ++)
+                tmp_buf_dst[j] = tmp_buf_src[j];
+        }
+}
+
+
 Gather_scatter_rearrange_info::Gather_scatter_rearrange_info(Field_mem_info *local_field)
 {
     int num_local_cells, i, field_total_dim_size_before_H2D, field_total_dim_size_after_H2D;
@@ -70,6 +104,29 @@ Gather_scatter_rearrange_info::Gather_scatter_rearrange_info(Field_mem_info *loc
     mpibuf = NULL;
     rearrange_indexes = NULL;
     global_field_mem = NULL;
+    parallel_output_initialized = false;
+    output_group_comm = MPI_COMM_NULL;
+    output_aggregators_comm = MPI_COMM_NULL;
+    output_group_counts = NULL;
+    output_group_displs = NULL;
+    output_cell_type = MPI_DATATYPE_NULL;
+    output_group_buf = NULL;
+    output_runs_buf = NULL;
+    num_output_sorted_cells = 0;
+    output_sorted_cells_src_offset = NULL;
+    output_sorted_cells_level_stride = NULL;
+    num_output_runs = 0;
+    output_runs_offset = NULL;
+    output_runs_length = NULL;
+    parallel_input_initialized = false;
+    num_input_local_cells = 0;
+    num_input_sorted_cells = 0;
+    input_cells_sorted_position = NULL;
+    input_global_data_size = 0;
+    input_runs_buf = NULL;
+    num_input_runs = 0;
+    input_runs_offset = NULL;
+    input_runs_length = NULL;
     host_comp_id = local_field->get_host_comp_id();
     original_decomp_id = local_field->get_decomp_id();
     grid_id = local_field->get_grid_id();
@@ -87,6 +144,7 @@ Gather_scatter_rearrange_info::Gather_scatter_rearrange_info(Field_mem_info *loc
 
     has_global_field = true;
     num_local_cells = decomps_info_mgr->get_decomp_info(original_decomp_id)->get_num_local_cells();
+    num_global_cells = decomps_info_mgr->get_decomp_info(original_decomp_id)->get_num_global_cells();
 	
 	local_field->get_total_dim_size_before_and_after_H2D(field_total_dim_size_before_H2D, field_total_dim_size_after_H2D);
     if (num_local_cells > 0) {
@@ -138,13 +196,21 @@ Gather_scatter_rearrange_info::Gather_scatter_rearrange_info(Field_mem_info *loc
             displs[i] *= num_points_in_each_cell*num_levels;
             counts[i] *= num_points_in_each_cell*num_levels;
         }
-        mpibuf = new char [num_total_cells*num_points_in_each_cell*num_levels*get_data_type_size(data_type)];
-        EXECUTION_REPORT_LOG(REPORT_LOG,-1, true, "allocate global field for gather/scatter");
-        global_field_mem = memory_manager->alloc_mem("IO_gather_field", new_decomp_id, grid_id, BUF_MARK_GATHER, data_type, "no unit", "allocate gather field", false);
     }
 }
 
 
+void Gather_scatter_rearrange_info::allocate_global_field()
+{
+    if (!has_global_field || current_proc_local_id != 0 || global_field_mem != NULL)
+        return;
+
+    mpibuf = new char [num_total_cells*num_points_in_each_cell*num_levels*get_data_type_size(data_type)];
+    EXECUTION_REPORT_LOG(REPORT_LOG,-1, true, "allocate global field for gather/scatter");
+    global_field_mem = memory_manager->alloc_mem("IO_gather_field", new_decomp_id, grid_id, BUF_MARK_GATHER, data_type, "no unit", "allocate gather field", false);
+}
+
+
 bool Gather_scatter_rearrange_info::match(int host_comp_id, int decomp_id, int grid_id, const char *data_type)
 {
     return this->host_comp_id == host_comp_id && this->original_decomp_id == decomp_id && this->grid_id == grid_id && words_are_the_same(this->data_type, data_type);
@@ -153,6 +219,7 @@ bool Gather_scatter_rearrange_info::match(int host_comp_id, int decomp_id, int g
 
 void Gather_scatter_rearrange_info::copy_in_local_field_info(Field_mem_info *local_field_mem)
 {
+    allocate_global_field();
     if (global_field_mem == NULL)
         return; 
 
@@ -270,10 +337,328 @@ Gather_scatter_rearrange_info::~Gather_scatter_rearrange_info()
         delete [] mpibuf;
     if (rearrange_indexes != NULL)
         delete [] rearrange_indexes;
+    if (output_cell_type != MPI_DATATYPE_NULL)
+        MPI_Type_free(&output_cell_type);
+    if (output_group_counts != NULL)
+        delete [] output_group_counts;
+    if (output_group_displs != NULL)
+        delete [] output_group_displs;
+    if (output_group_buf != NULL)
+        delete [] output_group_buf;
+    if (output_runs_buf != NULL)
+        delete [] output_runs_buf;
+    if (output_sorted_cells_src_offset != NULL)
+        delete [] output_sorted_cells_src_offset;
+    if (output_sorted_cells_level_stride != NULL)
+        delete [] output_sorted_cells_level_stride;
+    if (output_runs_offset != NULL)
+        delete [] output_runs_offset;
+    if (output_runs_length != NULL)
+        delete [] output_runs_length;
+    if (output_group_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&output_group_comm);
+    if (output_aggregators_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&output_aggregators_comm);
+    if (input_cells_sorted_position != NULL)
+        delete [] input_cells_sorted_position;
+    if (input_runs_buf != NULL)
+        delete [] input_runs_buf;
+    if (input_runs_offset != NULL)
+        delete [] input_runs_offset;
+    if (input_runs_length != NULL)
+        delete [] input_runs_length;
 }
 
 
-Gather_scatter_rearrange_info *Fields_gather_scatter_mgt::apply_gather_scatter_rearrange_info(Field_mem_info *local_field)
+/* The processes of the component are divided into groups of consecutive processes, 
+   and the first process of each group is an output aggregator. An aggregator only 
+   gathers the local data of its group, so that no process holds a global field */
+void Gather_scatter_rearrange_info::initialize_parallel_output()
+{
+    int num_output_groups, proc_id_in_group, num_procs_in_group, num_local_cells, num_group_cells, i, j, m;
+    int *group_cells_count = NULL, *group_cells_displs = NULL, *group_cells_global_indx = NULL;
+    std::vector<std::pair<int, long> > sorted_cells;
+    std::vector<long> runs_start, runs_length;
+    MPI_Datatype data_element_type;
+
+
+    if (parallel_output_initialized)
+        return;
+    parallel_output_initialized = true;
+
+    /* The gather of a group is counted in cells so that the counts do not overflow for large groups */
+    if (get_data_type_size(data_type) == 1)
+        data_element_type = MPI_CHAR;
+    else if (get_data_type_size(data_type) == 2)
+        data_element_type = MPI_SHORT;
+    else if (get_data_type_size(data_type) == 4)
+        data_element_type = MPI_INT;
+    else if (get_data_type_size(data_type) == 8)
+        data_element_type = MPI_DOUBLE;
+    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler error in Gather_scatter_rearrange_info::initialize_parallel_output\n");
+    MPI_Type_contiguous(num_levels*num_points_in_each_cell, data_element_type, &output_cell_type);
+    MPI_Type_commit(&output_cell_type);
+
+    num_output_groups = history_output_aggregators < num_local_procs? history_output_aggregators : num_local_procs;
+    MPI_Comm_split(local_comm, (int)(((long)current_proc_local_id)*num_output_groups/num_local_procs), current_proc_local_id, &output_group_comm);
+    MPI_Comm_rank(output_group_comm, &proc_id_in_group);
+    MPI_Comm_size(output_group_comm, &num_procs_in_group);
+    MPI_Comm_split(local_comm, proc_id_in_group == 0? 0 : MPI_UNDEFINED, current_proc_local_id, &output_aggregators_comm);
+
+    num_local_cells = decomps_info_mgr->get_decomp_info(original_decomp_id)->get_num_local_cells();
+    if (proc_id_in_group == 0) {
+        output_group_counts = new int [num_procs_in_group];
+        output_group_displs = new int [num_procs_in_group];
+        group_cells_count = new int [num_procs_in_group];
+        group_cells_displs = new int [num_procs_in_group];
+    }
+    MPI_Gather(&num_local_cells, 1, MPI_INT, group_cells_count, 1, MPI_INT, 0, output_group_comm);
+    if (proc_id_in_group == 0) {
+        for (m = 0, num_group_cells = 0; m < num_procs_in_group; m ++) {
+            group_cells_displs[m] = num_group_cells;
+            num_group_cells += group_cells_count[m];
+        }
+        group_cells_global_indx = new int [num_group_cells];
+    }
+    MPI_Gatherv((int*)decomps_info_mgr->get_decomp_info(original_decomp_id)->get_local_cell_global_indx(), num_local_cells, MPI_INT, group_cells_global_indx, group_cells_count, group_cells_displs, MPI_INT, 0, output_group_comm);
+    if (proc_id_in_group != 0)
+        return;
+
+    for (m = 0; m < num_procs_in_group; m ++) {
+        output_group_counts[m] = group_cells_count[m];
+        output_group_displs[m] = group_cells_displs[m];
+        for (i = 0; i < group_cells_count[m]; i ++)
+            if (group_cells_global_indx[group_cells_displs[m]+i] != CCPL_NULL_INT)
+                sorted_cells.push_back(std::make_pair(group_cells_global_indx[group_cells_displs[m]+i], ((long)m) << 32 | i));
+    }
+    std::sort(sorted_cells.begin(), sorted_cells.end());
+    output_sorted_cells_src_offset = new long [sorted_cells.size()];
+    output_sorted_cells_level_stride = new long [sorted_cells.size()];
+    for (j = 0, num_output_sorted_cells = 0; j < sorted_cells.size(); j ++) {
+        if (num_output_sorted_cells > 0 && sorted_cells[j].first == sorted_cells[j-1].first)
+            continue;
+        m = (int)(sorted_cells[j].second >> 32);
+        i = (int)(sorted_cells[j].second & 0xFFFFFFFF);
+        output_sorted_cells_src_offset[num_output_sorted_cells] = ((long)group_cells_displs[m])*num_levels*num_points_in_each_cell + ((long)i)*num_points_in_each_cell;
+        output_sorted_cells_level_stride[num_output_sorted_cells] = ((long)group_cells_count[m])*num_points_in_each_cell;
+        if (runs_start.size() > 0 && runs_start.back() + runs_length.back() == sorted_cells[j].first)
+            runs_length.back() ++;
+        else {
+            runs_start.push_back(sorted_cells[j].first);
+            runs_length.push_back(1);
+        }
+        num_output_sorted_cells ++;
+    }
+    
+    num_output_runs = num_levels * runs_start.size();
+    output_runs_offset = new long [num_output_runs];
+    output_runs_length = new long [num_output_runs];
+    for (i = 0; i < num_levels; i ++)
+        for (j = 0; j < runs_start.size(); j ++) {
+            output_runs_offset[i*runs_start.size()+j] = (((long)i)*num_global_cells + runs_start[j]) * num_points_in_each_cell;
+            output_runs_length[i*runs_start.size()+j] = runs_length[j] * num_points_in_each_cell;
+        }
+    output_group_buf = new char [(((long)group_cells_displs[num_procs_in_group-1])+group_cells_count[num_procs_in_group-1])*num_levels*num_points_in_each_cell*get_data_type_size(data_type)];
+    output_runs_buf = new char [((long)num_output_sorted_cells)*num_levels*num_points_in_each_cell*get_data_type_size(data_type)];
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "generate parallel output info for (%s %s %s): %d cells and %d runs at the aggregator", decomps_info_mgr->get_decomp_info(original_decomp_id)->get_decomp_name(), decomps_info_mgr->get_decomp_info(original_decomp_id)->get_grid_name(), data_type, num_output_sorted_cells, num_output_runs);
+
+    delete [] group_cells_count;
+    delete [] group_cells_displs;
+    delete [] group_cells_global_indx;
+}
+
+
+Remap_grid_data_class *Gather_scatter_rearrange_info::generate_output_field_template(Field_mem_info *local_field_mem)
+{
+    Remap_data_field *local_data_field = local_field_mem->get_field_data()->get_grid_data_field();
+    Remap_data_field *template_data_field = new Remap_data_field;
+
+
+    strcpy(template_data_field->field_name_in_application, local_data_field->field_name_in_application);
+    strcpy(template_data_field->field_name_in_IO_file, local_data_field->field_name_in_IO_file);
+    strcpy(template_data_field->data_type_in_application, local_data_field->data_type_in_application);
+    strcpy(template_data_field->data_type_in_IO_file, local_data_field->data_type_in_application);
+    template_data_field->fill_value = local_data_field->fill_value;
+    template_data_field->have_fill_value = local_data_field->have_fill_value;
+    for (int i = 0; i < local_data_field->field_attributes.size(); i ++)
+        template_data_field->field_attributes.push_back(local_data_field->field_attributes[i]);
+    template_data_field->required_data_size = ((long)num_global_cells) * num_levels * num_points_in_each_cell;
+    template_data_field->read_data_size = template_data_field->required_data_size;
+
+    return new Remap_grid_data_class(decomp_grids_mgr->search_decomp_grid_info(new_decomp_id, original_grid_mgr->get_original_CoR_grid(grid_id), false)->get_decomp_grid(), template_data_field);
+}
+
+
+bool Gather_scatter_rearrange_info::is_parallel_output_applicable()
+{
+    if (history_output_aggregators <= 0 || !has_global_field)
+        return false;
+
+    return decomp_grids_mgr->search_decomp_grid_info(new_decomp_id, original_grid_mgr->get_original_CoR_grid(grid_id), false)->get_decomp_grid()->get_grid_mask_field() == NULL;
+}
+
+
+/* Each output aggregator gathers the data of its group, reorders them into runs 
+   of consecutive global cells and writes its runs into the file. The root process 
+   defines the field in the file beforehand. Writes of aggregators are serialized 
+   because a netCDF file cannot be written by more than one process at a time */
+void Gather_scatter_rearrange_info::parallel_write_field(IO_netcdf *nc_file, Field_mem_info *local_field_mem, bool write_grid_name, int date, int datesec, bool is_restart_field)
+{
+    char IO_file_name[NAME_STR_SIZE], var_name[NAME_STR_SIZE];
+    long dim_sizes[256];
+    int num_dims, time_pos, aggregator_id, num_aggregators, token = 0;
+    double fill_value = 0;
+    IO_netcdf *aggregator_nc_file;
+    MPI_Status status;
+
+
+    if (execution_phase_number == 0)
+        return;
+
+    initialize_parallel_output();
+
+    local_field_mem->transformation_between_chunks_array(true);
+    MPI_Gatherv(local_field_mem->get_data_buf(), decomps_info_mgr->get_decomp_info(original_decomp_id)->get_num_local_cells(), output_cell_type, output_group_buf, output_group_counts, output_group_displs, output_cell_type, 0, output_group_comm);
+    if (output_aggregators_comm == MPI_COMM_NULL)
+        return;
+
+    MPI_Comm_rank(output_aggregators_comm, &aggregator_id);
+    MPI_Comm_size(output_aggregators_comm, &num_aggregators);
+    if (aggregator_id == 0) {
+        Remap_grid_data_class *output_field_template = generate_output_field_template(local_field_mem);
+        num_dims = nc_file->define_grided_data(output_field_template, write_grid_name, date, datesec, var_name, dim_sizes, time_pos);
+        strcpy(IO_file_name, nc_file->get_file_name());
+        delete output_field_template;
+    }
+    MPI_Bcast(IO_file_name, NAME_STR_SIZE, MPI_CHAR, 0, output_aggregators_comm);
+    MPI_Bcast(var_name, NAME_STR_SIZE, MPI_CHAR, 0, output_aggregators_comm);
+    MPI_Bcast(&num_dims, 1, MPI_INT, 0, output_aggregators_comm);
+    MPI_Bcast(&time_pos, 1, MPI_INT, 0, output_aggregators_comm);
+    MPI_Bcast(dim_sizes, num_dims, MPI_LONG, 0, output_aggregators_comm);
+
+    if (get_data_type_size(data_type) == 1)
+        rearrange_output_data((char*) output_group_buf, (char*) output_runs_buf);
+    else if (get_data_type_size(data_type) == 2)
+        rearrange_output_data((short*) output_group_buf, (short*) output_runs_buf);
+    else if (get_data_type_size(data_type) == 4)
+        rearrange_output_data((int*) output_group_buf, (int*) output_runs_buf);
+    else if (get_data_type_size(data_type) == 8)
+        rearrange_output_data((double*) output_group_buf, (double*) output_runs_buf);
+    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler error in Gather_scatter_rearrange_info::parallel_write_field\n");
+
+    if (aggregator_id > 0)
+        MPI_Recv(&token, 1, MPI_INT, aggregator_id-1, 0, output_aggregators_comm, &status);
+    if (aggregator_id == 0)
+        aggregator_nc_file = nc_file;
+    else aggregator_nc_file = new IO_netcdf(IO_file_name, IO_file_name, "a", time_pos >= 0);
+    local_field_mem->get_field_data()->get_grid_data_field()->read_fill_value();
+    if (local_field_mem->get_field_data()->get_grid_data_field()->have_fill_value)
+        fill_value = local_field_mem->get_field_data()->get_grid_data_field()->fill_value;
+    aggregator_nc_file->copy_data_buf_for_IO(data_type, output_runs_buf, fill_value, ((long)num_output_sorted_cells)*num_levels*num_points_in_each_cell, is_restart_field);
+    aggregator_nc_file->write_field_data_runs(var_name, data_type, output_runs_buf, time_pos, num_dims, dim_sizes, num_output_runs, output_runs_offset, output_runs_length);
+    if (aggregator_id > 0)
+        delete aggregator_nc_file;
+    if (aggregator_id < num_aggregators-1)
+        MPI_Send(&token, 1, MPI_INT, aggregator_id+1, 0, output_aggregators_comm);
+    MPI_Barrier(output_aggregators_comm);
+}
+
+
+/* Each process reads the runs of consecutive global cells that cover its local cells, 
+   so that a field is read without a global copy on the root process. The sizes of
+   levels and points are taken from the processes that have local cells */
+void Gather_scatter_rearrange_info::initialize_parallel_input()
+{
+    int i, j;
+    const int *local_cell_global_indx;
+    std::vector<std::pair<int, int> > sorted_cells;
+    std::vector<long> runs_start, runs_length;
+
+
+    if (parallel_input_initialized)
+        return;
+    parallel_input_initialized = true;
+
+    input_global_data_size = ((long)num_global_cells) * num_levels * num_points_in_each_cell;
+
+    num_input_local_cells = decomps_info_mgr->get_decomp_info(original_decomp_id)->get_num_local_cells();
+    local_cell_global_indx = decomps_info_mgr->get_decomp_info(original_decomp_id)->get_local_cell_global_indx();
+    if (num_input_local_cells == 0)
+        return;
+
+    input_cells_sorted_position = new int [num_input_local_cells];
+    for (i = 0; i < num_input_local_cells; i ++) {
+        input_cells_sorted_position[i] = -1;
+        if (local_cell_global_indx[i] != CCPL_NULL_INT)
+            sorted_cells.push_back(std::make_pair(local_cell_global_indx[i], i));
+    }
+    std::sort(sorted_cells.begin(), sorted_cells.end());
+    for (j = 0; j < sorted_cells.size(); j ++) {
+        if (num_input_sorted_cells > 0 && sorted_cells[j].first == sorted_cells[j-1].first) {
+            input_cells_sorted_position[sorted_cells[j].second] = num_input_sorted_cells - 1;
+            continue;
+        }
+        input_cells_sorted_position[sorted_cells[j].second] = num_input_sorted_cells;
+        if (runs_start.size() > 0 && runs_start.back() + runs_length.back() == sorted_cells[j].first)
+            runs_length.back() ++;
+        else {
+            runs_start.push_back(sorted_cells[j].first);
+            runs_length.push_back(1);
+        }
+        num_input_sorted_cells ++;
+    }
+
+    num_input_runs = num_levels * runs_start.size();
+    input_runs_offset = new long [num_input_runs];
+    input_runs_length = new long [num_input_runs];
+    for (i = 0; i < num_levels; i ++)
+        for (j = 0; j < runs_start.size(); j ++) {
+            input_runs_offset[i*runs_start.size()+j] = (((long)i)*num_global_cells + runs_start[j]) * num_points_in_each_cell;
+            input_runs_length[i*runs_start.size()+j] = runs_length[j] * num_points_in_each_cell;
+        }
+    input_runs_buf = new char [((long)num_input_sorted_cells)*num_levels*num_points_in_each_cell*get_data_type_size(data_type)];
+    EXECUTION_REPORT_LOG(REPORT_LOG, -1, true, "generate parallel input info for (%s %s %s): %d cells and %d runs at the current process", decomps_info_mgr->get_decomp_info(original_decomp_id)->get_decomp_name(), decomps_info_mgr->get_decomp_info(original_decomp_id)->get_grid_name(), data_type, num_input_sorted_cells, num_input_runs);
+}
+
+
+/* Only numeric data types are read in parallel, for which netCDF does the same 
+   data type conversion as IO_netcdf::read_data */
+bool Gather_scatter_rearrange_info::is_parallel_input_applicable()
+{
+    if (parallel_restart_read <= 0 || !has_global_field)
+        return false;
+
+    return words_are_the_same(data_type, DATA_TYPE_FLOAT) || words_are_the_same(data_type, DATA_TYPE_DOUBLE) || words_are_the_same(data_type, DATA_TYPE_INT) || words_are_the_same(data_type, DATA_TYPE_SHORT);
+}
+
+
+bool Gather_scatter_rearrange_info::parallel_read_field(IO_netcdf *nc_file, Field_mem_info *local_field_mem, const char *field_IO_name, int time_pos, bool check_existence)
+{
+    bool has_data_in_file;
+
+
+    initialize_parallel_input();
+
+    if (field_IO_name == NULL)
+        field_IO_name = local_field_mem->get_field_data()->get_grid_data_field()->field_name_in_IO_file;
+    has_data_in_file = nc_file->read_field_data_runs(field_IO_name, data_type, input_runs_buf, time_pos, input_global_data_size, num_input_runs, input_runs_offset, input_runs_length, check_existence);
+    if (!has_data_in_file)
+        return false;
+
+    if (get_data_type_size(data_type) == 2)
+        rearrange_input_data((short*) input_runs_buf, (short*) local_field_mem->get_data_buf());
+    else if (get_data_type_size(data_type) == 4)
+        rearrange_input_data((int*) input_runs_buf, (int*) local_field_mem->get_data_buf());
+    else if (get_data_type_size(data_type) == 8)
+        rearrange_input_data((double*) input_runs_buf, (double*) local_field_mem->get_data_buf());
+    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler error in Gather_scatter_rearrange_info::parallel_read_field\n");
+
+    local_field_mem->transformation_between_chunks_array(false);
+    return true;
+}
+
+
+Gather_scatter_rearrange_info *Fields_gather_scatter_mgt::search_gather_scatter_rearrange_info(Field_mem_info *local_field)
 {
     int i;
     Gather_scatter_rearrange_info *rearrange_info;
@@ -281,14 +666,17 @@ Gather_scatter_rearrange_info *Fields_gather_scatter_mgt::apply_gather_scatter_r
 
     for (i = 0; i < gather_scatter_rearrange_infos.size(); i ++)
         if (gather_scatter_rearrange_infos[i]->match(local_field->get_host_comp_id(), local_field->get_decomp_id(), local_field->get_grid_id(), local_field->get_field_data()->get_grid_data_field()->data_type_in_application))
-            break;
+            return gather_scatter_rearrange_infos[i];
 
-    if (i == gather_scatter_rearrange_infos.size()) {
-        rearrange_info = new Gather_scatter_rearrange_info(local_field);
-        gather_scatter_rearrange_infos.push_back(rearrange_info);
-    }
-    else rearrange_info = gather_scatter_rearrange_infos[i];
+    rearrange_info = new Gather_scatter_rearrange_info(local_field);
+    gather_scatter_rearrange_infos.push_back(rearrange_info);
+    return rearrange_info;
+}
 
+
+Gather_scatter_rearrange_info *Fields_gather_scatter_mgt::apply_gather_scatter_rearrange_info(Field_mem_info *local_field)
+{
+    Gather_scatter_rearrange_info *rearrange_info = search_gather_scatter_rearrange_info(local_field);
     rearrange_info->copy_in_local_field_info(local_field);
     return rearrange_info;
 }
@@ -302,6 +690,16 @@ Field_mem_info *Fields_gather_scatter_mgt::gather_field(Field_mem_info *local_fi
 
 void Fields_gather_scatter_mgt::gather_write_field(IO_netcdf *nc_file, Field_mem_info *local_field, bool write_grid_name, int date, int datesec, bool is_restart_field)
 {
+    Gather_scatter_rearrange_info *rearrange_info = search_gather_scatter_rearrange_info(local_field);
+    Remap_data_field *local_data_field = local_field->get_field_data()->get_grid_data_field();
+    bool is_IO_data_type_converted = !is_restart_field && strlen(local_data_field->data_type_in_IO_file) > 0 && !words_are_the_same(local_data_field->data_type_in_IO_file, local_data_field->data_type_in_application);
+
+
+    if (rearrange_info->is_parallel_output_applicable() && !is_IO_data_type_converted) {
+        rearrange_info->parallel_write_field(nc_file, local_field, write_grid_name, date, datesec, is_restart_field);
+        return;
+    }
+
     Field_mem_info *global_field = gather_field(local_field);
     if (comp_comm_group_mgt_mgr->get_current_proc_id_in_comp(local_field->get_host_comp_id(), "in gather_write_field") == 0)
         nc_file->write_grided_data(global_field->get_field_data(), write_grid_name, date, datesec, is_restart_field);
@@ -313,6 +711,9 @@ bool Fields_gather_scatter_mgt::read_scatter_field(IO_netcdf *nc_file, Field_mem
     bool has_data_in_file;
     
 
+    if (search_gather_scatter_rearrange_info(local_field)->is_parallel_input_applicable())
+        return search_gather_scatter_rearrange_info(local_field)->parallel_read_field(nc_file, local_field, field_IO_name, time_pos, check_existence);
+
     Gather_scatter_rearrange_info *rearrage_info = apply_gather_scatter_rearrange_info(local_field);
     if (comp_comm_group_mgt_mgr->get_current_proc_id_in_comp(local_field->get_host_comp_id(), "in read_scatter_field") == 0) {
         if (field_IO_name != NULL)
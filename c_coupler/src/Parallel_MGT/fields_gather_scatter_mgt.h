@@ -40,6 +40,37 @@ class Gather_scatter_rearrange_info
         int current_proc_local_id;
         MPI_Comm local_comm;
 
+        bool parallel_output_initialized;
+        int num_global_cells;
+        MPI_Comm output_group_comm;
+        MPI_Comm output_aggregators_comm;
+        int *output_group_counts;
+        int *output_group_displs;
+        MPI_Datatype output_cell_type;
+        char *output_group_buf;
+        char *output_runs_buf;
+        int num_output_sorted_cells;
+        long *output_sorted_cells_src_offset;
+        long *output_sorted_cells_level_stride;
+        int num_output_runs;
+        long *output_runs_offset;
+        long *output_runs_length;
+
+        bool parallel_input_initialized;
+        int num_input_local_cells;
+        int num_input_sorted_cells;
+        int *input_cells_sorted_position;
+        long input_global_data_size;
+        char *input_runs_buf;
+        int num_input_runs;
+        long *input_runs_offset;
+        long *input_runs_length;
+
+        void allocate_global_field();
+        void initialize_parallel_output();
+        void initialize_parallel_input();
+        Remap_grid_data_class *generate_output_field_template(Field_mem_info*);
+
     public:
         Gather_scatter_rearrange_info(Field_mem_info*);
         ~Gather_scatter_rearrange_info();
@@ -50,6 +81,12 @@ class Gather_scatter_rearrange_info
         Field_mem_info *get_global_field(Field_mem_info*);
         template <class T> void rearrange_gather_data(T*, T*, int);
         template <class T> void rearrange_scatter_data(T*, T*, int);
+        template <class T> void rearrange_output_data(T*, T*);
+        template <class T> void rearrange_input_data(T*, T*);
+        bool is_parallel_output_applicable();
+        void parallel_write_field(IO_netcdf*, Field_mem_info*, bool, int, int, bool);
+        bool is_parallel_input_applicable();
+        bool parallel_read_field(IO_netcdf*, Field_mem_info*, const char*, int, bool);
 };
 
 
@@ -57,6 +94,7 @@ class Fields_gather_scatter_mgt
 {
     private: 
         std::vector<Gather_scatter_rearrange_info*> gather_scatter_rearrange_infos;
+        Gather_scatter_rearrange_info *search_gather_scatter_rearrange_info(Field_mem_info*);
         Gather_scatter_rearrange_info *apply_gather_scatter_rearrange_info(Field_mem_info*);
 
     public:
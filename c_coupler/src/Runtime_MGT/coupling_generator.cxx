@@ -186,8 +186,21 @@ void Coupling_connection::create_union_comm()
     int src_comp_num_procs = src_comp_node->get_num_procs();
     int dst_comp_num_procs = dst_comp_node->get_num_procs();
     std::vector<int> src_procs_global_ids, dst_procs_global_ids;
+    Union_comm_info *cached_union_comm;
 
 
+    cached_union_comm = coupling_generator->search_union_comm(src_comp_interfaces[0].first, dst_comp_full_name);
+    if (cached_union_comm != NULL) {
+        union_comm = cached_union_comm->union_comm;
+        src_proc_ranks_in_union_comm = cached_union_comm->src_proc_ranks_in_union_comm;
+        dst_proc_ranks_in_union_comm = cached_union_comm->dst_proc_ranks_in_union_comm;
+        if (current_proc_id_src_comp != -1)
+            EXECUTION_REPORT_LOG(REPORT_LOG, src_comp_node->get_comp_id(), true, "reuse the union comm between components \"%s\" and \"%s\". The connection id is %d", src_comp_interfaces[0].first, dst_comp_full_name, connection_id);
+        if (current_proc_id_dst_comp != -1)
+            EXECUTION_REPORT_LOG(REPORT_LOG, dst_comp_node->get_comp_id(), true, "reuse the union comm between components \"%s\" and \"%s\". The connection id is %d", src_comp_interfaces[0].first, dst_comp_full_name, connection_id);
+        return;
+    }
+
     if (current_proc_id_src_comp != -1) {
         EXECUTION_REPORT_LOG(REPORT_LOG, src_comp_node->get_comp_id(), true, "start to create union comm between components \"%s\" and \"%s\". The connection id is %d", src_comp_interfaces[0].first, dst_comp_full_name, connection_id);
         MPI_Barrier(src_comp_node->get_comm_group());
@@ -207,6 +220,7 @@ void Coupling_connection::create_union_comm()
         dst_proc_ranks_in_union_comm = new int[dst_comp_num_procs]; 
 
     union_comm = create_union_comm_common(src_comp_node->get_comm_group(), dst_comp_node->get_comm_group(), current_proc_id_src_comp, current_proc_id_dst_comp, src_procs_global_ids, dst_procs_global_ids, connection_id, src_proc_ranks_in_union_comm, dst_proc_ranks_in_union_comm);
+    coupling_generator->add_union_comm(src_comp_interfaces[0].first, dst_comp_full_name, union_comm, src_proc_ranks_in_union_comm, dst_proc_ranks_in_union_comm);
     
     if (current_proc_id_src_comp != -1)
         EXECUTION_REPORT_LOG(REPORT_LOG, src_comp_node->get_comp_id(), true, "Finish creating union comm between components \"%s\" and \"%s\". The connection id is %d", src_comp_interfaces[0].first, dst_comp_full_name, connection_id);
@@ -296,8 +310,10 @@ bool Coupling_connection::exchange_grid(Comp_comm_group_mgt_node *sender_comp_no
     char *temp_array_buffer = NULL;
     long buffer_max_size, buffer_content_size;
     int original_grid_status, *all_original_grid_status, num_processes, bottom_field_variation_type, V3D_lev_field_variation_type;
-    long checksum_lon, checksum_lat, checksum_mask;
+    long checksum_lon, checksum_lat, checksum_mask, local_grid_checksum[4], grid_checksum[4];
+    int cache_status, overall_cache_status;
     bool should_exchange_grid = false;
+    Original_grid_info *received_original_grid = NULL;
 
 
     Original_grid_info *sender_original_grid = original_grid_mgr->search_grid_info(grid_name, sender_comp_node->get_comp_id());
@@ -335,16 +351,42 @@ bool Coupling_connection::exchange_grid(Comp_comm_group_mgt_node *sender_comp_no
         return true;
     }
 
-    if (sender_comp_node->get_current_proc_local_id() != -1) 
-        EXECUTION_REPORT_LOG(REPORT_LOG, sender_comp_node->get_comp_id(), true, "Send grid %s to component \"%s\"", grid_name, receiver_comp_node->get_full_name());
-    if (receiver_comp_node->get_current_proc_local_id() != -1) 
-        EXECUTION_REPORT_LOG(REPORT_LOG, receiver_comp_node->get_comp_id(), true, "Receive grid %s from component \"%s\"", grid_name, sender_comp_node->get_full_name());
-
-    if (sender_original_grid != NULL)
-        sender_original_grid->write_grid_into_array(&temp_array_buffer, buffer_max_size, buffer_content_size);
-    transfer_array_from_one_comp_to_another(sender_comp_node->get_current_proc_local_id(), sender_comp_node->get_root_proc_global_id(), receiver_comp_node->get_current_proc_local_id(), receiver_comp_node->get_root_proc_global_id(), receiver_comp_node->get_comm_group(), &temp_array_buffer, buffer_content_size);
-
-    if (original_grid_status == 0) {
+    for (int i = 0; i < 4; i ++)
+        local_grid_checksum[i] = 0;
+    if (sender_comp_node->get_current_proc_local_id() == 0) {
+        sender_original_grid->get_serialized_grid_hash(local_grid_checksum[0], local_grid_checksum[1]);
+        local_grid_checksum[2] = sender_original_grid->get_checksum_H2D_mask();
+        local_grid_checksum[3] = sender_original_grid->get_original_CoR_grid()->get_grid_size();
+    }
+    MPI_Allreduce(local_grid_checksum, grid_checksum, 4, MPI_LONG, MPI_SUM, union_comm);
+    if (original_grid_status == 0)
+        received_original_grid = coupling_generator->search_received_grid(grid_checksum[0], grid_checksum[1]);
+    if (received_original_grid != NULL && (received_original_grid->get_checksum_H2D_mask() != grid_checksum[2] || received_original_grid->get_original_CoR_grid()->get_grid_size() != grid_checksum[3])) {
+        EXECUTION_REPORT_LOG(REPORT_LOG, receiver_comp_node->get_comp_id(), true, "The grid %s from component \"%s\" has the same hash as a grid received before but differs in its mask or size, so it will be received again", grid_name, sender_comp_node->get_full_name());
+        received_original_grid = NULL;
+    }
+    cache_status = original_grid_status == 0 && received_original_grid == NULL? 1 : 0;
+    MPI_Allreduce(&cache_status, &overall_cache_status, 1, MPI_INT, MPI_MAX, union_comm);
+
+    if (overall_cache_status == 1) {
+        if (sender_comp_node->get_current_proc_local_id() != -1) 
+            EXECUTION_REPORT_LOG(REPORT_LOG, sender_comp_node->get_comp_id(), true, "Send grid %s to component \"%s\"", grid_name, receiver_comp_node->get_full_name());
+        if (receiver_comp_node->get_current_proc_local_id() != -1) 
+            EXECUTION_REPORT_LOG(REPORT_LOG, receiver_comp_node->get_comp_id(), true, "Receive grid %s from component \"%s\"", grid_name, sender_comp_node->get_full_name());
+        if (sender_comp_node->get_current_proc_local_id() == 0)
+            sender_original_grid->write_grid_into_array(&temp_array_buffer, buffer_max_size, buffer_content_size);
+        transfer_array_from_one_comp_to_another(sender_comp_node->get_current_proc_local_id(), sender_comp_node->get_root_proc_global_id(), receiver_comp_node->get_current_proc_local_id(), receiver_comp_node->get_root_proc_global_id(), receiver_comp_node->get_comm_group(), &temp_array_buffer, buffer_content_size);
+    }
+    else if (receiver_comp_node->get_current_proc_local_id() != -1) 
+        EXECUTION_REPORT_LOG(REPORT_LOG, receiver_comp_node->get_comp_id(), true, "Does not receive grid %s from component \"%s\" because the same grid has been received before", grid_name, sender_comp_node->get_full_name());
+
+    if (original_grid_status == 0 && received_original_grid != NULL) {
+        receiver_original_grid = original_grid_mgr->get_original_grid(original_grid_mgr->add_original_grid(sender_comp_node->get_comp_id(), grid_name, received_original_grid->get_original_CoR_grid()));
+        receiver_original_grid->set_bottom_field_variation_type(received_original_grid->get_bottom_field_variation_type());
+        receiver_original_grid->set_V3D_lev_field_variation_type(received_original_grid->get_V3D_lev_field_variation_type());
+        receiver_original_grid->set_grid_checksum(received_original_grid->get_checksum_H2D_mask());
+    }
+    else if (original_grid_status == 0) {
         read_data_from_array_buffer(&checksum_mask, sizeof(long), temp_array_buffer, buffer_content_size, true);
         read_data_from_array_buffer(&bottom_field_variation_type, sizeof(int), temp_array_buffer, buffer_content_size, true);
         read_data_from_array_buffer(&V3D_lev_field_variation_type, sizeof(int), temp_array_buffer, buffer_content_size, true);
@@ -357,6 +399,7 @@ bool Coupling_connection::exchange_grid(Comp_comm_group_mgt_node *sender_comp_no
         receiver_original_grid->set_bottom_field_variation_type(bottom_field_variation_type);
 		receiver_original_grid->set_V3D_lev_field_variation_type(V3D_lev_field_variation_type);
         receiver_original_grid->set_grid_checksum(checksum_mask);
+        coupling_generator->add_received_grid(grid_checksum[0], grid_checksum[1], receiver_original_grid);
     }
 
     if (temp_array_buffer != NULL)
@@ -1048,6 +1091,24 @@ void Coupling_generator::clear()
 }
 
 
+Original_grid_info *Coupling_generator::search_received_grid(long grid_hash, long grid_array_size)
+{
+    std::map<std::pair<long,long>, Original_grid_info*>::iterator iter = received_grids.find(std::make_pair(grid_hash, grid_array_size));
+
+
+    if (iter == received_grids.end())
+        return NULL;
+    return iter->second;
+}
+
+
+void Coupling_generator::add_received_grid(long grid_hash, long grid_array_size, Original_grid_info *original_grid)
+{
+    if (received_grids.find(std::make_pair(grid_hash, grid_array_size)) == received_grids.end())
+        received_grids[std::make_pair(grid_hash, grid_array_size)] = original_grid;
+}
+
+
 void Coupling_generator::synchronize_latest_connection_id(MPI_Comm comm)
 {
     int overall_latest_connection_id;
@@ -170,6 +170,16 @@ class Component_import_interfaces_configuration
 
 
 
+struct Union_comm_info
+{
+    char src_comp_full_name[NAME_STR_SIZE];
+    char dst_comp_full_name[NAME_STR_SIZE];
+    MPI_Comm union_comm;
+    int *src_proc_ranks_in_union_comm;
+    int *dst_proc_ranks_in_union_comm;
+};
+
+
 class Coupling_generator
 {
     private:
@@ -181,6 +191,8 @@ class Coupling_generator
         Dictionary<int> *export_field_index_lookup_table;
         std::vector<Coupling_connection*> all_coupling_connections;
         std::vector<Coupling_connection*> all_IO_connections;
+        std::map<std::pair<long,long>, Original_grid_info*> received_grids;
+        std::vector<Union_comm_info> union_comms;
         int latest_connection_id;
         
         void generate_interface_fields_source_dst(const char*, int);
@@ -198,6 +210,10 @@ class Coupling_generator
         int get_latest_connection_id() { return latest_connection_id; }
         void set_latest_connection_id(int connection_id) { latest_connection_id = connection_id; }
         void synchronize_latest_connection_id(MPI_Comm);
+        Original_grid_info *search_received_grid(long, long);
+        void add_received_grid(long, long, Original_grid_info*);
+        Union_comm_info *search_union_comm(const char*, const char*);
+        void add_union_comm(const char*, const char*, MPI_Comm, int*, int*);
         void transfer_interfaces_info_from_one_component_to_another(std::vector<Inout_interface*> &, Comp_comm_group_mgt_node *, Comp_comm_group_mgt_node *);
         void begin_external_coupling_generation();
         void add_comp_for_external_coupling_generation(const char *, int, const char*);
@@ -38,7 +38,9 @@ void Ensemble_mgt::Initialize(int ensemble_member_id, int have_random_seed_for_p
             this->perturbation_type_id = 3;
         else if (words_are_the_same("xor_last_bit_with_a_bit", perturbation_type))
             this->perturbation_type_id = 4;
-        else EXECUTION_REPORT(REPORT_ERROR,-1, false, "\"%s\" is not a right selection for perturbing the roundoff errors of the registered fields. Existing selections include set_last_bit_to_1, set_last_bit_to_0, reverse_last_bit and xor_last_bit_with_a_bit", perturbation_type);
+        else if (words_are_the_same("counter_based_random_last_bit", perturbation_type))
+            this->perturbation_type_id = 5;
+        else EXECUTION_REPORT(REPORT_ERROR,-1, false, "\"%s\" is not a right selection for perturbing the roundoff errors of the registered fields. Existing selections include set_last_bit_to_1, set_last_bit_to_0, reverse_last_bit, xor_last_bit_with_a_bit and counter_based_random_last_bit", perturbation_type);
         srand(root_random_seed_for_perturbation);
         for (int i = 0; i < ensemble_member_id; i ++)
             this->ensemble_random_seed_for_perturbation = rand();
@@ -62,79 +64,115 @@ void Ensemble_mgt::register_a_field_for_perturbation(void *data_buf)
 }
 
 
-void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_1(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
+/* Branch-free kernels on the bit patterns of the array elements: the unsigned integer type T has the same size as the
+   floating-point type of the field, so that every loop below is a plain element-wise operation that can be vectorized */
+template<typename T> void perturb_last_bit_with_masks(T *field_data_buf, long field_size, T and_mask, T or_mask, T xor_mask)
 {
-    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++) 
-            ((int*) field_data_buf)[i] = (((int*) field_data_buf)[i] | ((int)1));
-    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = (((long*) field_data_buf)[i] | ((long)1));
-    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_set_last_bit_to_1");
+#ifdef _OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+    for (long i = 0; i < field_size; i ++)
+        field_data_buf[i] = ((field_data_buf[i] & and_mask) | or_mask) ^ xor_mask;
 }
 
 
-void Ensemble_mgt::perturb_a_field_through_set_last_bit_to_0(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
+template<typename T> void perturb_last_bit_through_xor_with_a_bit(T *field_data_buf, long field_size, unsigned int number_perturbing_bit)
 {
-    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++) 
-            ((int*) field_data_buf)[i] = (((int*) field_data_buf)[i] & ((int)0xFFFFFFFE));
-    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = (((long*) field_data_buf)[i] & ((long)0xFFFFFFFFFFFFFFFE));
-    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_set_last_bit_to_0");
+#ifdef _OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+    for (long i = 0; i < field_size; i ++)
+        field_data_buf[i] = field_data_buf[i] ^ ((field_data_buf[i] >> number_perturbing_bit) & ((T)1));
 }
 
 
-void Ensemble_mgt::perturb_a_field_through_reverse_last_bit(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
+/* Counter-based random bit: a stateless hash (the finalizer of splitmix64) of the seed and the global index of an 
+   element, so that the perturbation does not depend on the parallel decomposition or on the order of processing */
+static inline unsigned long counter_based_random_bits(unsigned long key, unsigned long counter)
 {
-    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-        for (long i = 0; i < field_size; i ++)
-            ((int*) field_data_buf)[i] = ((int*) field_data_buf)[i] ^ ((int)1);
-    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-        for (long i = 0; i < field_size; i ++) 
-            ((long*) field_data_buf)[i] = ((long*) field_data_buf)[i] ^ ((long)1);
-    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_a_field_through_reverse_last_bit");
+    unsigned long z = key + (counter+1)*((unsigned long)0x9E3779B97F4A7C15);
+
+
+    z = (z ^ (z >> 30)) * ((unsigned long)0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * ((unsigned long)0x94D049BB133111EB);
+    return z ^ (z >> 31);
 }
 
 
-void Ensemble_mgt::perturb_a_field_through_xor_last_bit_with_a_bit(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
-{    
-    if (words_are_the_same(data_type, DATA_TYPE_FLOAT)) {
-        unsigned int number_perturbing_bit = (((unsigned int) current_random_number) >> 1)%32;
-        unsigned int perturbing_bitmap = (((unsigned int)1) << number_perturbing_bit);
-        for (long i = 0; i < field_size; i ++) {
-            unsigned int perturbing_bit_value = ((((unsigned int*)field_data_buf)[i] & perturbing_bitmap) >> number_perturbing_bit);
-            if (!(perturbing_bit_value == 0 || perturbing_bit_value == 1))
-                EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error1 in perturb_a_field_through_xor_last_bit_with_a_bit");
-            ((unsigned int*) field_data_buf)[i] = ((unsigned int*) field_data_buf)[i] ^ perturbing_bit_value;
-        }
-    }
-    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE)) {
-        unsigned int number_perturbing_bit = (((unsigned int) current_random_number) >> 1)%64;
-        unsigned long perturbing_bitmap = (((unsigned long)1) << number_perturbing_bit);
-        for (long i = 0; i < field_size; i ++) {
-            unsigned long perturbing_bit_value = ((((unsigned long*)field_data_buf)[i] & perturbing_bitmap) >> number_perturbing_bit);
-            if (!(perturbing_bit_value == 0 || perturbing_bit_value == 1))
-                EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error2 in perturb_a_field_through_xor_last_bit_with_a_bit");
-            ((unsigned long*) field_data_buf)[i] = ((unsigned long*) field_data_buf)[i] ^ perturbing_bit_value;
-        }
-    }
-    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error3 in perturb_a_field_through_xor_last_bit_with_a_bit");
+template<typename T> void perturb_last_bit_with_counter_based_random_bits(T *field_data_buf, long field_size, unsigned long key, unsigned long global_index_start)
+{
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for (long i = 0; i < field_size; i ++)
+        field_data_buf[i] = field_data_buf[i] ^ ((T)(counter_based_random_bits(key, global_index_start+i) & 1));
 }
 
 
-void Ensemble_mgt::perturb_an_array(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
+template<typename T> void perturb_an_array_of_bits(T *field_data_buf, long field_size, int perturbation_type_id, int current_random_number)
 {
     if (perturbation_type_id == 1)
-        perturb_a_field_through_set_last_bit_to_1(field_data_buf, data_type, field_size, current_random_number);
+        perturb_last_bit_with_masks<T>(field_data_buf, field_size, ~((T)0), (T)1, (T)0);
     else if (perturbation_type_id == 2)
-        perturb_a_field_through_set_last_bit_to_0(field_data_buf, data_type, field_size, current_random_number);
+        perturb_last_bit_with_masks<T>(field_data_buf, field_size, ~((T)1), (T)0, (T)0);
     else if (perturbation_type_id == 3)
-        perturb_a_field_through_reverse_last_bit(field_data_buf, data_type, field_size, current_random_number);
+        perturb_last_bit_with_masks<T>(field_data_buf, field_size, ~((T)0), (T)0, (T)1);
     else if (perturbation_type_id == 4)
-        perturb_a_field_through_xor_last_bit_with_a_bit(field_data_buf, data_type, field_size, current_random_number);
-    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in Ensemble_mgt::run");
+        perturb_last_bit_through_xor_with_a_bit<T>(field_data_buf, field_size, (((unsigned int) current_random_number) >> 1)%(sizeof(T)*8));
+    else if (perturbation_type_id == 5)
+        perturb_last_bit_with_counter_based_random_bits<T>(field_data_buf, field_size, (unsigned long) current_random_number, 0);
+    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in perturb_an_array_of_bits");
+}
+
+
+void Ensemble_mgt::perturb_an_array(void *field_data_buf, const char *data_type, long field_size, int current_random_number)
+{
+    if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+        perturb_an_array_of_bits<unsigned int>((unsigned int*) field_data_buf, field_size, perturbation_type_id, current_random_number);
+    else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+        perturb_an_array_of_bits<unsigned long>((unsigned long*) field_data_buf, field_size, perturbation_type_id, current_random_number);
+    else EXECUTION_REPORT(REPORT_ERROR,-1, false, "C-Coupler software error in Ensemble_mgt::perturb_an_array");
+}
+
+
+void Ensemble_mgt::perturb_a_field_with_counter_based_random_bits(Field_mem_info *field, unsigned long key)
+{
+    int total_dim_size_before_H2D = 1, total_dim_size_after_H2D = 1, num_local_cells, num_global_cells;
+    const int *local_cell_global_indx;
+    const char *data_type = field->get_field_data()->get_grid_data_field()->data_type_in_application;
+    char *data_buf = (char*) field->get_data_buf();
+    long local_offset, global_offset;
+    Decomp_info *decomp_info;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, field->get_num_chunks() == 0, "The field \"%s\" is registered in chunks, which is not supported by the perturbation \"counter_based_random_last_bit\" in the ensemble experiment of perturbing roundoff errors. Please use another perturbation type or register the field without chunks.", field->get_field_name());
+
+    if (field->get_decomp_id() == -1) {
+        /// the values are replicated on all processes: the local index is the global index
+        if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+            perturb_last_bit_with_counter_based_random_bits<unsigned int>((unsigned int*) data_buf, field->get_size_of_field(), key, 0);
+        else perturb_last_bit_with_counter_based_random_bits<unsigned long>((unsigned long*) data_buf, field->get_size_of_field(), key, 0);
+        return;
+    }
+
+    decomp_info = decomps_info_mgr->get_decomp_info(field->get_decomp_id());
+    num_local_cells = decomp_info->get_num_local_cells();
+    num_global_cells = decomp_info->get_num_global_cells();
+    local_cell_global_indx = decomp_info->get_local_cell_global_indx();
+    field->get_total_dim_size_before_and_after_H2D(total_dim_size_before_H2D, total_dim_size_after_H2D);
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static) private(local_offset, global_offset)
+#endif
+    for (int k = 0; k < total_dim_size_after_H2D; k ++)
+        for (int j = 0; j < num_local_cells; j ++) {
+            if (local_cell_global_indx[j] == CCPL_NULL_INT)
+                continue;
+            local_offset = (((long)k)*num_local_cells+j)*total_dim_size_before_H2D;
+            global_offset = (((long)k)*num_global_cells+local_cell_global_indx[j])*total_dim_size_before_H2D;
+            if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+                perturb_last_bit_with_counter_based_random_bits<unsigned int>(((unsigned int*) data_buf)+local_offset, total_dim_size_before_H2D, key, global_offset);
+            else perturb_last_bit_with_counter_based_random_bits<unsigned long>(((unsigned long*) data_buf)+local_offset, total_dim_size_before_H2D, key, global_offset);
+        }
 }
 
 
@@ -169,7 +207,9 @@ void Ensemble_mgt::run()
 
     for (int i = 0; i < registered_fields_for_perturbation.size(); i ++) {
         EXECUTION_REPORT_LOG(REPORT_LOG,-1, true, "Perturb the values of field %s (on grid %s) with random roundoff errors", registered_fields_for_perturbation[i]->get_field_name(), registered_fields_for_perturbation[i]->get_grid_name());
-        perturb_an_array(registered_fields_for_perturbation[i]->get_data_buf(), registered_fields_for_perturbation[i]->get_field_data()->get_grid_data_field()->data_type_in_application,
+        if (perturbation_type_id == 5)
+            perturb_a_field_with_counter_based_random_bits(registered_fields_for_perturbation[i], counter_based_random_bits((unsigned long) ensemble_random_seed_for_perturbation, i));
+        else perturb_an_array(registered_fields_for_perturbation[i]->get_data_buf(), registered_fields_for_perturbation[i]->get_field_data()->get_grid_data_field()->data_type_in_application,
                          registered_fields_for_perturbation[i]->get_size_of_field(), current_random_number);
     }
 }
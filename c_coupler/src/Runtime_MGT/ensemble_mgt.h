@@ -25,11 +25,8 @@ class Ensemble_mgt
         int perturbation_type_id;
         std::vector<Field_mem_info *> registered_fields_for_perturbation;
         
-        void perturb_a_field_through_set_last_bit_to_1(void*, const char*, long, int);
-        void perturb_a_field_through_set_last_bit_to_0(void*, const char*, long, int);
-        void perturb_a_field_through_reverse_last_bit(void*, const char*, long, int);
-        void perturb_a_field_through_xor_last_bit_with_a_bit(void*, const char*, long, int);
         void perturb_an_array(void*, const char*, long, int);
+        void perturb_a_field_with_counter_based_random_bits(Field_mem_info*, unsigned long);
 
     public:
         Ensemble_mgt();
@@ -9,6 +9,9 @@
 
 #include <mpi.h>
 #include <dlfcn.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "global_data.h"
 #include "external_procedures_mgt.h"
 
@@ -338,12 +341,28 @@ const char *External_procedure_inst::lookup_model_field_name(const char *procedu
 
 
 void External_procedure_inst::run(int chunk_index, const char *annotation)
+{
+	run_interface_before_procedure(annotation);
+	run_procedure(chunk_index);
+	run_interface_after_procedure(annotation);
+}
+
+
+void External_procedure_inst::run_interface_before_procedure(const char *annotation)
 {
 	if (inout_interface_before_run != NULL)
 		inout_interface_before_run->execute(true, API_ID_EXTERNAL_PROC_INST_RUN, field_update_status, procedure_import_field_insts.size()+procedure_export_field_insts.size()+1, annotation);
+}
 
+
+void External_procedure_inst::run_procedure(int chunk_index)
+{
 	procedure_run(&instance_id,&chunk_index);
+}
+
 
+void External_procedure_inst::run_interface_after_procedure(const char *annotation)
+{
 	if (inout_interface_after_run != NULL)
 		inout_interface_after_run->execute(true, API_ID_EXTERNAL_PROC_INST_RUN, field_update_status, procedure_import_field_insts.size()+procedure_export_field_insts.size()+1, annotation);
 }
@@ -396,6 +415,8 @@ void External_procedures_operation::initialize_data(External_procedures_inst *ex
 	this->num_session_threads = 0;
 	this->num_omp_levels = num_omp_levels;
 	this->host_comp_id = comp_id;
+	this->sessions_independent = false;
+	this->sessions_run_concurrently = false;
 }
 
 
@@ -438,6 +459,8 @@ External_procedures_operation::External_procedures_operation(External_procedures
 		}		
 		for (int i = 0; i < children_operations.size(); i ++)
 			this->num_total_threads += children_operations[i]->get_num_session_threads();
+		sessions_independent = are_sessions_independent(comp_id);
+		sessions_run_concurrently = sessions_independent && is_thread_multiple_supported(comp_id);
 	}
 	else if (words_are_the_same(XML_element->Value(), "parallel_session")) {
 		const char *num_threads_str = get_XML_attribute(comp_id, -1, XML_element, "num_threads", XML_file_name, line_number, "the number of threads for the corresponding OpenMP parallel session", "external procedures configuration", true);
@@ -472,6 +495,159 @@ External_procedures_operation::~External_procedures_operation()
 {
 	for (int i = 0; i < children_operations.size(); i ++)
 		delete children_operations[i];
+	for (int i = 0; i < sessions_comms.size(); i ++)
+		MPI_Comm_free(&sessions_comms[i]);
+}
+
+
+/* A parallel session can run concurrently with others only when it is a plain sequence of procedures */
+bool External_procedures_operation::get_session_procedure_insts(std::vector<External_procedure_inst*> &procedure_insts)
+{
+	if (loop_count != 1 || external_procedure_inst != NULL)
+		return false;
+	for (int i = 0; i < children_operations.size(); i ++) {
+		if (children_operations[i]->external_procedure_inst == NULL || children_operations[i]->children_operations.size() > 0 || children_operations[i]->loop_count != 1)
+			return false;
+		procedure_insts.push_back(children_operations[i]->external_procedure_inst);
+	}
+
+	return true;
+}
+
+
+/* The sessions of an "openmp_parallel" node are independent when no session exports a field instance that 
+   another session imports or exports, according to the import/export field lists of the procedures */
+bool External_procedures_operation::are_sessions_independent(int comp_id)
+{
+	std::vector<std::vector<Field_mem_info*> > sessions_import_field_insts, sessions_export_field_insts;
+
+
+	if (children_operations.size() <= 1)
+		return false;
+
+	sessions_import_field_insts.resize(children_operations.size());
+	sessions_export_field_insts.resize(children_operations.size());
+	for (int i = 0; i < children_operations.size(); i ++) {
+		std::vector<External_procedure_inst*> procedure_insts;
+		if (!children_operations[i]->get_session_procedure_insts(procedure_insts))
+			return false;
+		for (int j = 0; j < procedure_insts.size(); j ++) {
+			procedure_insts[j]->get_procedures_import_field_insts(sessions_import_field_insts[i]);
+			procedure_insts[j]->get_procedures_export_field_insts(sessions_export_field_insts[i]);
+		}
+	}
+
+	for (int i = 0; i < children_operations.size(); i ++)
+		for (int j = 0; j < children_operations.size(); j ++) {
+			if (i == j)
+				continue;
+			for (int k = 0; k < sessions_export_field_insts[i].size(); k ++) {
+				for (int l = 0; l < sessions_import_field_insts[j].size(); l ++)
+					if (sessions_export_field_insts[i][k] == sessions_import_field_insts[j][l])
+						return false;
+				for (int l = 0; l < sessions_export_field_insts[j].size(); l ++)
+					if (sessions_export_field_insts[i][k] == sessions_export_field_insts[j][l])
+						return false;
+			}
+		}
+
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The %ld parallel sessions of an \"openmp_parallel\" node of the external procedures instance \"%s\" are independent and can run concurrently with %d threads in total", children_operations.size(), external_procedures_inst->instance_name, num_total_threads);
+
+	return true;
+}
+
+
+/* The procedures of concurrent sessions may call MPI from their own threads, so the sessions run concurrently only 
+   when MPI has been initialized with MPI_THREAD_MULTIPLE */
+bool External_procedures_operation::is_thread_multiple_supported(int comp_id)
+{
+	int thread_support_level;
+
+
+#ifdef _OPENMP
+	MPI_Query_thread(&thread_support_level);
+	if (thread_support_level == MPI_THREAD_MULTIPLE)
+		return true;
+	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "The parallel sessions of an \"openmp_parallel\" node of the external procedures instance \"%s\" will run one after another because MPI is not initialized with MPI_THREAD_MULTIPLE", external_procedures_inst->instance_name);
+#endif
+
+	return false;
+}
+
+
+/* The sessions advance in rounds: in round j, the interfaces before the j-th procedures of all sessions are executed 
+   sequentially in the original order, the j-th procedures then run concurrently, each session on a team with its own 
+   number of threads, and the interfaces after them are executed sequentially again. So every procedure still runs 
+   between its own interfaces, and the coupling interfaces, which are not thread-safe, keep the same order on all processes. 
+   Each session has its own duplicate of the local communicator of the instance, so that the collectives of the procedures 
+   in different sessions never match each other */
+void External_procedures_operation::run_sessions_concurrently(int chunk_index, const char *annotation)
+{
+	std::vector<std::vector<External_procedure_inst*> > sessions_procedure_insts;
+	int num_rounds = 0;
+
+
+	if (sessions_comms.size() == 0) {
+		sessions_comms.resize(children_operations.size());
+		for (int i = 0; i < children_operations.size(); i ++)
+			MPI_Comm_dup(external_procedures_inst->local_comm, &sessions_comms[i]);
+	}
+	sessions_procedure_insts.resize(children_operations.size());
+	for (int i = 0; i < children_operations.size(); i ++) {
+		children_operations[i]->get_session_procedure_insts(sessions_procedure_insts[i]);
+		if (num_rounds < sessions_procedure_insts[i].size())
+			num_rounds = sessions_procedure_insts[i].size();
+	}
+
+	for (int j = 0; j < num_rounds; j ++) {
+		for (int i = 0; i < children_operations.size(); i ++)
+			if (j < sessions_procedure_insts[i].size())
+				sessions_procedure_insts[i][j]->run_interface_before_procedure(annotation);
+#ifdef _OPENMP
+		external_procedures_inst->running_sessions_of_threads.resize(children_operations.size());
+		external_procedures_inst->running_sessions_omp_level = omp_get_level() + 1;
+		external_procedures_inst->running_sessions_comms = &sessions_comms;
+#pragma omp parallel for num_threads(children_operations.size()) schedule(static, 1)
+#endif
+		for (int i = 0; i < children_operations.size(); i ++) {
+			if (j >= sessions_procedure_insts[i].size())
+				continue;
+#ifdef _OPENMP
+			external_procedures_inst->running_sessions_of_threads[omp_get_thread_num()] = i;
+			omp_set_num_threads(children_operations[i]->get_num_session_threads());
+#endif
+			sessions_procedure_insts[i][j]->run_procedure(chunk_index);
+		}
+		external_procedures_inst->running_sessions_comms = NULL;
+		for (int i = 0; i < children_operations.size(); i ++)
+			if (j < sessions_procedure_insts[i].size())
+				sessions_procedure_insts[i][j]->run_interface_after_procedure(annotation);
+	}
+}
+
+
+/* The sessions and the OpenMP regions of the procedures in them need num_omp_levels+1 active levels of parallelism. 
+   The nesting setting of the model is not changed: with fewer active levels, the sessions run one after another */
+bool External_procedures_operation::are_enough_omp_levels_active()
+{
+#ifdef _OPENMP
+	return omp_get_max_active_levels() > num_omp_levels;
+#else
+	return false;
+#endif
+}
+
+
+/* Whether the sessions run concurrently is decided by all processes of the instance together, because the interfaces 
+   of the sessions are executed in a different order when the sessions run one after another */
+bool External_procedures_operation::can_sessions_run_concurrently()
+{
+	int local_status = sessions_run_concurrently && are_enough_omp_levels_active()? 1 : 0, status;
+
+
+	MPI_Allreduce(&local_status, &status, 1, MPI_INT, MPI_MIN, external_procedures_inst->local_comm);
+
+	return status == 1;
 }
 
 
@@ -479,7 +655,9 @@ void External_procedures_operation::run(int chunk_index, const char * annotation
 {
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, loop_count >= 1 && !(children_operations.size() > 0 && external_procedure_inst != NULL), "Software error in External_procedures_operation::run");
 	for (int j = 0; j < loop_count; j ++) {
-		for (int i = 0; i < children_operations.size(); i ++)
+		if (sessions_independent && can_sessions_run_concurrently())
+			run_sessions_concurrently(chunk_index, annotation);
+		else for (int i = 0; i < children_operations.size(); i ++)
 			children_operations[i]->run(chunk_index, annotation);
 		if (external_procedure_inst != NULL)
 			external_procedure_inst->run(chunk_index, annotation);
@@ -568,6 +746,8 @@ External_procedures_inst::External_procedures_inst(int instance_id, const char *
 
 	annotation_mgr->add_annotation(instance_id, "registering an instance of external procedures", annotation);
 	external_procedures_mgr->add_external_procedures_inst(this);
+	running_sessions_comms = NULL;
+	running_sessions_omp_level = 0;
 
 	for (int i = 0; i < API_specified_field_insts.size(); i ++)
 		for (int j = i+1; j < API_specified_field_insts.size(); j ++)
@@ -606,6 +786,18 @@ External_procedures_inst::~External_procedures_inst()
 }
 
 
+/* While the sessions of an "openmp_parallel" node run concurrently, the procedures get the communicator of their own session */
+MPI_Comm External_procedures_inst::get_local_comm()
+{
+#ifdef _OPENMP
+	if (running_sessions_comms != NULL && omp_get_level() >= running_sessions_omp_level)
+		return (*running_sessions_comms)[running_sessions_of_threads[omp_get_ancestor_thread_num(running_sessions_omp_level)]];
+#endif
+
+	return local_comm;
+}
+
+
 TiXmlElement *External_procedures_inst::get_XML_file_with_configuration()
 {
 	char current_XML_file_name[NAME_STR_SIZE];
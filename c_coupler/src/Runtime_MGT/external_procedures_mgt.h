@@ -75,6 +75,9 @@ class External_procedure_inst
 		const char *lookup_model_field_name(const char*);
 		bool does_require_coupling_parameters() { return require_coupling_parameters; }
 		void run(int, const char*);
+		void run_interface_before_procedure(const char*);
+		void run_procedure(int);
+		void run_interface_after_procedure(const char*);
 		void get_procedures_import_field_insts(std::vector<Field_mem_info*> &);
 		void get_procedures_export_field_insts(std::vector<Field_mem_info*> &);
 };
@@ -91,9 +94,18 @@ class External_procedures_operation
 		int num_session_threads;
 		int num_omp_levels;
 		std::vector<External_procedures_operation *> children_operations;
+		std::vector<MPI_Comm> sessions_comms;
+		bool sessions_independent;
+		bool sessions_run_concurrently;
 
 		int get_num_session_threads() { return num_session_threads; }		
 		void initialize_data(External_procedures_inst *, int, int);
+		bool get_session_procedure_insts(std::vector<External_procedure_inst*> &);
+		bool are_sessions_independent(int);
+		bool is_thread_multiple_supported(int);
+		bool are_enough_omp_levels_active();
+		bool can_sessions_run_concurrently();
+		void run_sessions_concurrently(int, const char *);
 		
 	public:
 		External_procedures_operation(External_procedures_inst *, int, TiXmlElement *, const char *, int, const char *, int, const char*);
@@ -127,6 +139,9 @@ class External_procedures_inst
 		std::vector<int> timer_ids;
 		std::vector<External_procedure_inst*> external_procedure_insts;
 		External_procedures_operation *root_operation;
+		std::vector<MPI_Comm> *running_sessions_comms;
+		std::vector<int> running_sessions_of_threads;
+		int running_sessions_omp_level;
 		bool finalized;
 
 	public:		
@@ -140,7 +155,7 @@ class External_procedures_inst
 		int get_num_specified_field_instances() { return API_specified_field_insts.size(); }
 		int get_num_timers() { return timer_ids.size(); }
 		int get_instance_id() { return instance_id; }
-		MPI_Comm get_local_comm() { return local_comm; }
+		MPI_Comm get_local_comm();
 		int get_grid_id(int grid_index) { return grid_ids[grid_index-1]; }
 		int get_decomp_id(int decomp_index) { return decomp_ids[decomp_index-1]; }
 		int get_control_var(int control_var_index) { return control_vars[control_var_index-1]; }
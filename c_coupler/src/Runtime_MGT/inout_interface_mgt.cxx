@@ -60,6 +60,47 @@ void Connection_field_time_info::get_time_of_next_timer_on(bool advance)
 }
 
 
+/* Advances the current time step by step until it is later than bound_time, and records the last time when the 
+   timer is on. The number of steps is computed directly when the timer allows a closed-form computation. */
+void Connection_field_time_info::advance_to_bound_time(Time_mgt *time_mgr, long bound_time)
+{
+    long current_time = ((long)current_num_elapsed_days)*SECONDS_PER_DAY + current_second, last_step_time, last_timer_time;
+    int last_step_year = current_year, last_step_month = current_month, last_step_day = current_day, last_step_second = current_second, last_step_num_elapsed_days = current_num_elapsed_days;
+
+
+    if (current_time > bound_time)
+        return;
+
+    last_step_time = current_time + ((bound_time-current_time)/time_step_in_second)*time_step_in_second;
+    time_mgr->advance_time(last_step_year, last_step_month, last_step_day, last_step_second, last_step_num_elapsed_days, last_step_time-current_time);
+    if (timer->get_closest_timer_on_time(time_mgr, last_step_time, last_step_year, last_step_month, last_step_day, time_step_in_second, false, last_timer_time)) {
+        if (last_timer_time >= current_time) {
+            time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, last_timer_time-current_time);
+            last_timer_num_elapsed_days = current_num_elapsed_days;
+            last_timer_date = current_year*10000 + current_month*100 + current_day;
+            last_timer_second = current_second;
+        }
+        current_year = last_step_year;
+        current_month = last_step_month;
+        current_day = last_step_day;
+        current_second = last_step_second;
+        current_num_elapsed_days = last_step_num_elapsed_days;
+        time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
+        return;
+    }
+
+    while(((long)current_num_elapsed_days)*SECONDS_PER_DAY + current_second <= bound_time) {
+        if (timer->is_timer_on(current_year, current_month, current_day, current_second, current_num_elapsed_days, 
+                               time_mgr->get_start_year(), time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day())) {
+            last_timer_num_elapsed_days = current_num_elapsed_days;
+            last_timer_date = current_year*10000 + current_month*100 + current_day;
+            last_timer_second = current_second;
+        }    
+        time_mgr->advance_time(current_year, current_month, current_day, current_second, current_num_elapsed_days, time_step_in_second);
+    }
+}
+
+
 void Connection_field_time_info::write_restart_mgt_info(Restart_buffer_container *restart_buffer)
 {
     restart_buffer->dump_in_data(&current_year, sizeof(int));
@@ -172,6 +213,9 @@ Connection_coupling_procedure::Connection_coupling_procedure(Inout_interface *in
                 fields_mem_datatype_transformed[i] = memory_manager->alloc_mem(fields_mem_registered[i], BUF_MARK_DATATYPE_TRANS, coupling_connection->connection_id, transfer_data_type, 
                                                                                inout_interface->get_interface_source() == INTERFACE_SOURCE_REGISTER && i < coupling_connection->fields_name.size());
                 runtime_datatype_transform_algorithms[i] = new Runtime_datatype_transformer(fields_mem_inter_step_averaged[i], fields_mem_datatype_transformed[i]);
+                Runtime_cumulate_average_algorithm *last_averaging_algorithm = runtime_inter_averaging_algorithm[i] != NULL? runtime_inter_averaging_algorithm[i] : runtime_inner_averaging_algorithm[i];
+                if (last_averaging_algorithm != NULL)
+                    last_averaging_algorithm->fuse_datatype_transformation(runtime_datatype_transform_algorithms[i]);
             }    
         }    
         if (inout_interface->get_interface_type() == COUPLING_INTERFACE_MARK_IMPORT && !(inout_interface->get_parent_interface() != NULL && inout_interface->get_parent_interface()->get_interface_type() == COUPLING_INTERFACE_MARK_HALO_EXCHANGE)) {
@@ -267,6 +311,23 @@ Connection_coupling_procedure::~Connection_coupling_procedure()
 }
 
 
+void Connection_coupling_procedure::process_received_field(int i)
+{
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data interpolation");
+    if (runtime_remap_algorithms[i] != NULL)
+        runtime_remap_algorithms[i]->run(true);
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data interpolation");
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data type transformation");
+    if (runtime_datatype_transform_algorithms[i] != NULL)
+        runtime_datatype_transform_algorithms[i]->run(true);
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data type transformation");
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data average");
+    if (runtime_inter_averaging_algorithm[i] != NULL)
+        runtime_inter_averaging_algorithm[i]->run(true);
+    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data average");
+}
+
+
 void Connection_coupling_procedure::execute(bool bypass_timer, int *field_update_status, const char *annotation)
 {
     Time_mgt *time_mgr = components_time_mgrs->get_time_mgr(inout_interface->get_comp_id());
@@ -305,15 +366,7 @@ void Connection_coupling_procedure::execute(bool bypass_timer, int *field_update
                 local_fields_time_info->last_timer_second = local_fields_time_info->next_timer_second;
                 local_fields_time_info->get_time_of_next_timer_on(true);
             }
-            while((((long)remote_fields_time_info->current_num_elapsed_days)*((long)SECONDS_PER_DAY))+remote_fields_time_info->current_second+lag_seconds <= (((long)local_fields_time_info->current_num_elapsed_days)*((long)SECONDS_PER_DAY)) + local_fields_time_info->current_second) {
-                if (remote_fields_time_info->timer->is_timer_on(remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days, 
-                                                                time_mgr->get_start_year(), time_mgr->get_start_month(), time_mgr->get_start_day(), time_mgr->get_start_second(), time_mgr->get_start_num_elapsed_day())) {
-                    remote_fields_time_info->last_timer_num_elapsed_days = remote_fields_time_info->current_num_elapsed_days;
-					remote_fields_time_info->last_timer_date = remote_fields_time_info->current_year*10000 + remote_fields_time_info->current_month*100 + remote_fields_time_info->current_day;
-                    remote_fields_time_info->last_timer_second = remote_fields_time_info->current_second;
-                }    
-                time_mgr->advance_time(remote_fields_time_info->current_year, remote_fields_time_info->current_month, remote_fields_time_info->current_day, remote_fields_time_info->current_second, remote_fields_time_info->current_num_elapsed_days,  remote_fields_time_info->time_step_in_second);
-            }            
+            remote_fields_time_info->advance_to_bound_time(time_mgr, (((long)local_fields_time_info->current_num_elapsed_days)*((long)SECONDS_PER_DAY)) + local_fields_time_info->current_second - lag_seconds);
             remote_fields_time_info->get_time_of_next_timer_on(false);
         }
     }
@@ -361,23 +414,23 @@ void Connection_coupling_procedure::execute(bool bypass_timer, int *field_update
             }
             else {
                 runtime_data_transfer_algorithm->pass_transfer_parameters(current_remote_fields_time, inout_interface->get_bypass_counter());
-                runtime_data_transfer_algorithm->run(bypass_timer);
-                comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
-                for (int i = fields_mem_registered.size() - 1; i >= 0; i --) {
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data interpolation");
-                        if (runtime_remap_algorithms[i] != NULL)
-                            runtime_remap_algorithms[i]->run(true);
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data interpolation");
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data type transformation");
-                        if (runtime_datatype_transform_algorithms[i] != NULL)
-                            runtime_datatype_transform_algorithms[i]->run(true);                                
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data type transformation");
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, "data average");
-                        if (runtime_inter_averaging_algorithm[i] != NULL)
-                            runtime_inter_averaging_algorithm[i]->run(true);
-                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, "data average");
+                if (runtime_data_transfer_algorithm->is_pipelined_transfer()) {
+                    runtime_data_transfer_algorithm->start_receiving_fields(bypass_timer);
+                    for (int i = 0; i < fields_mem_registered.size(); i ++) {
+                        runtime_data_transfer_algorithm->receive_field(i);
+                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
+                        process_received_field(i);
+                        comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
+                    }
+                    runtime_data_transfer_algorithm->finish_receiving_fields(bypass_timer);
+                }
+                else {
+                    runtime_data_transfer_algorithm->run(bypass_timer);
+                    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
+                    for (int i = fields_mem_registered.size() - 1; i >= 0; i --)
+                        process_received_field(i);
+                    comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
                 }
-                comp_comm_group_mgt_mgr->get_global_node_of_local_comp(inout_interface->get_comp_id(),false,"")->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMPUTATION, -1, -1, inout_interface->get_interface_name());
                 if (!bypass_timer && !inout_interface->get_is_child_interface() && (restart_mgr->is_in_restart_write_window(current_remote_fields_elapsed_time, true))) {
                     EXECUTION_REPORT_LOG(REPORT_LOG, inout_interface->get_comp_id(), true, "Should write the remote data at the remote time %ld and local %ld into the restart data file", current_remote_fields_elapsed_time, time_mgr->get_current_num_elapsed_day()*((long)100000)+time_mgr->get_current_second());
                     for (int i = 0; i < fields_mem_registered.size(); i ++)
@@ -610,6 +663,7 @@ Inout_interface::Inout_interface(const char *temp_array_buffer, long &buffer_con
 
     restart_mgr = NULL;
     inversed_dst_fraction = NULL;
+    halo_exchange_algorithm = NULL;
 }
 
 
@@ -658,7 +712,7 @@ Inout_interface::Inout_interface(const char *interface_name, int interface_id, i
         fields_connected_status.push_back(false);
 		fields_coupling_procedures.push_back(NULL);
         if (interface_type == COUPLING_INTERFACE_MARK_IMPORT && !is_child_interface)
-            restart_mgr->add_restarted_field_instance(fields_mem_registered[fields_mem_registered.size()-1], true);
+            restart_mgr->add_restarted_field_instance(fields_mem_registered[fields_mem_registered.size()-1], true, true);
     }
     fields_connected_status.push_back(false);
     num_fields_connected = 0;
@@ -726,6 +780,7 @@ void Inout_interface::initialize_data(const char *interface_name, int interface_
     this->inversed_dst_fraction = NULL;
     this->fields_name.clear();
     this->is_last_halo_exchange_waited = true;
+    this->halo_exchange_algorithm = NULL;
     strcpy(this->interface_name, interface_name);
     strcpy(this->comp_full_name, comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"in Inout_interface::initialize_data")->get_full_name());
     this->inst_or_aver = inst_or_aver;
@@ -752,6 +807,9 @@ Inout_interface::~Inout_interface()
         delete [] fields_name[i];
     }
 
+    if (halo_exchange_algorithm != NULL)
+        delete halo_exchange_algorithm;
+
     for (int i = 0; i < coupling_procedures.size(); i ++)
         delete coupling_procedures[i];
 
@@ -1106,6 +1164,10 @@ void Inout_interface::execute(bool bypass_timer, int API_id, int *field_update_s
             field_update_status[i] = 0;
     }
 
+    if (!is_child_interface)
+        for (int i = 0; i < fields_mem_registered.size(); i ++)
+            restart_mgr->read_pending_restarted_field(fields_mem_registered[i]);
+
     if (!is_child_interface && !bypass_timer && !mgt_info_has_been_restarted && (time_mgr->get_runtype_mark() == RUNTYPE_MARK_CONTINUE || time_mgr->get_runtype_mark() == RUNTYPE_MARK_BRANCH)) {
         EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Import restart data for the interface \"%s\"\n", interface_name);
         import_restart_data(NULL);
@@ -1216,9 +1278,18 @@ void Inout_interface::do_halo_exchange(int API_id, bool is_asynchronous, const c
         get_API_hint(comp_id, API_id, API_label);
         EXECUTION_REPORT(REPORT_ERROR, comp_id, false, "Error happens when calling API \"%s\" to execute the halo exchange interface \"%s\": the last call for executing this interface is an asynchorous halo exchange while the model does not confirm that the asynchorous halo exchange has been ended safely. Please check the model code with the annotation \"%s\"", API_label, interface_name, annotation);
     }
-    children_interfaces[0]->execute(true, API_id, field_update_status, 4096, annotation);
-    if (!is_asynchronous)
-        children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
+    if (neighbor_halo_exchange > 0 && children_interfaces[0]->coupling_procedures.size() == 1 && children_interfaces[1]->coupling_procedures.size() == 1) {
+        if (halo_exchange_algorithm == NULL)
+            halo_exchange_algorithm = new Runtime_halo_exchange_algorithm(children_interfaces[0]->coupling_procedures[0]->runtime_data_transfer_algorithm, children_interfaces[1]->coupling_procedures[0]->runtime_data_transfer_algorithm);
+        halo_exchange_algorithm->start_exchange();
+        if (!is_asynchronous)
+            halo_exchange_algorithm->finish_exchange();
+    }
+    else {
+        children_interfaces[0]->execute(true, API_id, field_update_status, 4096, annotation);
+        if (!is_asynchronous)
+            children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
+    }
     is_last_halo_exchange_waited = (!is_asynchronous);
 }
 
@@ -1237,7 +1308,9 @@ void Inout_interface::finish_halo_exchange(int API_id, const char *annotation)
     if (is_last_halo_exchange_waited)
         return;
     
-    children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
+    if (halo_exchange_algorithm != NULL)
+        halo_exchange_algorithm->finish_exchange();
+    else children_interfaces[1]->execute(true, API_id, field_update_status, 4096, annotation);
     is_last_halo_exchange_waited = true;
 	for (int i = 0; i < children_interfaces[0]->fields_mem_registered.size(); i ++)
 		children_interfaces[0]->fields_mem_registered[i]->check_field_sum(report_internal_log_enabled, true, "after halo exchanging");
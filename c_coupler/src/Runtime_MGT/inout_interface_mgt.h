@@ -68,6 +68,7 @@ class Connection_field_time_info
 
         Connection_field_time_info(Inout_interface*, Coupling_timer*, int, int, int, int, int, int);
         void get_time_of_next_timer_on(bool);
+        void advance_to_bound_time(Time_mgt *, long);
         void reset_last_timer_info() { last_timer_num_elapsed_days = -1; last_timer_second = -1; }
         void write_restart_mgt_info(Restart_buffer_container*);        
         void import_restart_data(Restart_buffer_container*);
@@ -106,6 +107,8 @@ class Connection_coupling_procedure
         int remote_bypass_counter;
         bool is_coupling_time_out_of_execution;
 		long last_receive_sender_time;
+
+        void process_received_field(int);
         
     public:
         Connection_coupling_procedure(Inout_interface*, Coupling_connection*);
@@ -155,6 +158,7 @@ class Inout_interface
         int execution_checking_status;
         long last_execution_time;
         bool is_last_halo_exchange_waited;
+        Runtime_halo_exchange_algorithm *halo_exchange_algorithm;
         char *inversed_dst_fraction;
         long bypass_counter;
         int num_fields_connected;
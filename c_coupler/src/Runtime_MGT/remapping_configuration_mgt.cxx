@@ -153,7 +153,6 @@ bool H2D_remapping_wgt_file_info::match_H2D_remapping_wgt(Original_grid_info *sr
     }
     read_weight_grid_data(dst_original_grid->get_comp_id(), "area_a", DATA_TYPE_DOUBLE, (void**)(&src_area), src_grid_size, false);
     read_weight_grid_data(dst_original_grid->get_comp_id(), "area_b", DATA_TYPE_DOUBLE, (void**)(&dst_area), dst_grid_size, false);
-    read_remapping_weights(dst_original_grid->get_comp_id());
 
     matched_grid_pair.push_back(std::make_pair(src_original_grid, dst_original_grid));
     return true;
@@ -264,6 +263,11 @@ void H2D_remapping_wgt_file_info::read_remapping_weights(int comp_id)
     IO_netcdf *netcdf_file_object = new IO_netcdf("remapping weights file for H2D interpolation", wgt_file_name, "r", false);
     EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), src_grid_size > 0, "Error happens when reading the remapping weights file \"%s\": fail to read the size of the source grid (dimension \"n_a\" in the file). Please verify.", wgt_file_name);
     EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), dst_grid_size > 0, "Error happens when reading the remapping weights file \"%s\": fail to read the size of the target grid (dimension \"n_a\" in the file). Please verify.", wgt_file_name);
+    if (read_remapping_weights_in_parallel(comp_id, netcdf_file_object, file_read_comm, local_proc_id_in_file_read_comm, num_procs_in_file_read_comm)) {
+        delete netcdf_file_object;
+        MPI_Comm_free(&file_read_comm);
+        return;
+    }
     num_wgts = netcdf_file_object->get_dimension_size("n_s", file_read_comm, local_proc_id_in_file_read_comm == 0);    
     netcdf_file_object->read_file_field("col", (void**)(&temp_wgts_src_indexes), &field_size, data_type, file_read_comm, local_proc_id_in_file_read_comm == 0);
     EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), field_size == num_wgts && words_are_the_same(data_type, DATA_TYPE_INT), "Error happens when reading the remapping weights file \"%s\": fail to read the variable \"col\" because of wrong array size (should be dimension of \"n_s\") or wrong data type (should be integer). Please verify.", wgt_file_name);
@@ -288,6 +292,171 @@ void H2D_remapping_wgt_file_info::read_remapping_weights(int comp_id)
 }
 
 
+/* The owner of a dst cell is resolved by the process of the block of dst cells it belongs to: each process registers its 
+   local dst cells at the processes of their blocks, and the weights read in a slab query the owners of their dst cells 
+   in the same way. No process holds an array of owners of the whole dst grid */
+bool H2D_remapping_wgt_file_info::read_remapping_weights_in_parallel(int comp_id, IO_netcdf *netcdf_file_object, MPI_Comm file_read_comm, int local_proc_id_in_file_read_comm, int num_procs_in_file_read_comm)
+{
+    int *block_cells_owner, *temp_wgts_src_indexes, *temp_wgts_dst_indexes, *send_counts, *send_displs, *recv_counts, *recv_displs, *send_pos;
+    int *query_cells, *queried_cells, *queried_owners, *query_owners, *query_pos;
+    long *send_src_indexes, *send_dst_indexes, slab_start, slab_size, num_global_wgts, num_sent_wgts, num_local_wgts, num_received_cells, i, j;
+    double *slab_wgts_values, *send_wgts_values;
+    int has_shared_cells = 0, has_shared_cells_global, owner, block_size = (dst_grid_size+num_procs_in_file_read_comm-1) / num_procs_in_file_read_comm;
+    int block_start = block_size*local_proc_id_in_file_read_comm;
+    std::vector<int> local_dst_cells;
+
+
+    if (H2D_grid_decomp_mask == NULL || num_procs_in_file_read_comm == 1)
+        return false;
+
+    send_counts = new int [num_procs_in_file_read_comm];
+    send_displs = new int [num_procs_in_file_read_comm];
+    send_pos = new int [num_procs_in_file_read_comm];
+    recv_counts = new int [num_procs_in_file_read_comm];
+    recv_displs = new int [num_procs_in_file_read_comm];
+    block_cells_owner = new int [block_size];
+
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        send_counts[i] = 0;
+    for (i = 0; i < dst_grid_size; i ++)
+        if (H2D_grid_decomp_mask[i]) {
+            local_dst_cells.push_back(i);
+            send_counts[i/block_size] ++;
+        }
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, file_read_comm);
+    send_displs[0] = recv_displs[0] = 0;
+    for (i = 1; i < num_procs_in_file_read_comm; i ++) {
+        send_displs[i] = send_displs[i-1] + send_counts[i-1];
+        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+    }
+    num_received_cells = recv_displs[num_procs_in_file_read_comm-1] + recv_counts[num_procs_in_file_read_comm-1];
+    queried_cells = new int [num_received_cells];
+    MPI_Alltoallv(local_dst_cells.data(), send_counts, send_displs, MPI_INT, queried_cells, recv_counts, recv_displs, MPI_INT, file_read_comm);
+    for (i = 0; i < block_size; i ++)
+        block_cells_owner[i] = -1;
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        for (j = recv_displs[i]; j < recv_displs[i]+recv_counts[i]; j ++) {
+            if (block_cells_owner[queried_cells[j]-block_start] != -1)
+                has_shared_cells = 1;
+            block_cells_owner[queried_cells[j]-block_start] = i;
+        }
+    delete [] queried_cells;
+    MPI_Allreduce(&has_shared_cells, &has_shared_cells_global, 1, MPI_INT, MPI_MAX, file_read_comm);
+    if (has_shared_cells_global == 1) {
+        delete [] send_counts;
+        delete [] send_displs;
+        delete [] send_pos;
+        delete [] recv_counts;
+        delete [] recv_displs;
+        delete [] block_cells_owner;
+        return false;
+    }
+
+    num_global_wgts = netcdf_file_object->get_dimension_size("n_s", file_read_comm, local_proc_id_in_file_read_comm == 0);
+    EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), num_global_wgts >= 0, "Error happens when reading the remapping weights file \"%s\": fail to read the number of weights (dimension \"n_s\" in the file). Please verify.", wgt_file_name);
+    slab_start = num_global_wgts / num_procs_in_file_read_comm * local_proc_id_in_file_read_comm + std::min((long)local_proc_id_in_file_read_comm, num_global_wgts % num_procs_in_file_read_comm);
+    slab_size = num_global_wgts / num_procs_in_file_read_comm + (local_proc_id_in_file_read_comm < num_global_wgts % num_procs_in_file_read_comm? 1 : 0);
+    temp_wgts_src_indexes = new int [slab_size];
+    temp_wgts_dst_indexes = new int [slab_size];
+    slab_wgts_values = new double [slab_size];
+    netcdf_file_object->read_file_field_slab("col", DATA_TYPE_INT, num_global_wgts, slab_start, slab_size, temp_wgts_src_indexes);
+    netcdf_file_object->read_file_field_slab("row", DATA_TYPE_INT, num_global_wgts, slab_start, slab_size, temp_wgts_dst_indexes);
+    netcdf_file_object->read_file_field_slab("S", DATA_TYPE_DOUBLE, num_global_wgts, slab_start, slab_size, slab_wgts_values);
+
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        send_counts[i] = 0;
+    for (i = 0; i < slab_size; i ++) {
+        temp_wgts_src_indexes[i] --;
+        temp_wgts_dst_indexes[i] --;
+        EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), temp_wgts_src_indexes[i] >= 0 && temp_wgts_src_indexes[i] < src_grid_size, "Error happens when reading the remapping weights file \"%s\": some values in the variable \"col\" are out of the bound of source grid size. Please verify.", wgt_file_name);
+        EXECUTION_REPORT(REPORT_ERROR, comp_comm_group_mgt_mgr->get_global_node_root()->get_comp_id(), temp_wgts_dst_indexes[i] >= 0 && temp_wgts_dst_indexes[i] < dst_grid_size, "Error happens when reading the remapping weights file \"%s\": some values in the variable \"row\" are out of the bound of target grid size. Please verify.", wgt_file_name);
+        send_counts[temp_wgts_dst_indexes[i]/block_size] ++;
+    }
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, file_read_comm);
+    send_displs[0] = recv_displs[0] = 0;
+    for (i = 1; i < num_procs_in_file_read_comm; i ++) {
+        send_displs[i] = send_displs[i-1] + send_counts[i-1];
+        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+    }
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        send_pos[i] = send_displs[i];
+    query_cells = new int [slab_size];
+    query_owners = new int [slab_size];
+    query_pos = new int [slab_size];
+    for (i = 0; i < slab_size; i ++) {
+        query_pos[i] = send_pos[temp_wgts_dst_indexes[i]/block_size] ++;
+        query_cells[query_pos[i]] = temp_wgts_dst_indexes[i];
+    }
+    num_received_cells = recv_displs[num_procs_in_file_read_comm-1] + recv_counts[num_procs_in_file_read_comm-1];
+    queried_cells = new int [num_received_cells];
+    queried_owners = new int [num_received_cells];
+    MPI_Alltoallv(query_cells, send_counts, send_displs, MPI_INT, queried_cells, recv_counts, recv_displs, MPI_INT, file_read_comm);
+    for (i = 0; i < num_received_cells; i ++)
+        queried_owners[i] = block_cells_owner[queried_cells[i]-block_start];
+    MPI_Alltoallv(queried_owners, recv_counts, recv_displs, MPI_INT, query_owners, send_counts, send_displs, MPI_INT, file_read_comm);
+    delete [] query_cells;
+    delete [] queried_cells;
+    delete [] queried_owners;
+    delete [] block_cells_owner;
+
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        send_counts[i] = 0;
+    for (i = 0; i < slab_size; i ++) {
+        owner = query_owners[query_pos[i]];
+        if (owner != -1)
+            send_counts[owner] ++;
+    }
+    send_displs[0] = 0;
+    for (i = 1; i < num_procs_in_file_read_comm; i ++)
+        send_displs[i] = send_displs[i-1] + send_counts[i-1];
+    num_sent_wgts = send_displs[num_procs_in_file_read_comm-1] + send_counts[num_procs_in_file_read_comm-1];
+    send_src_indexes = new long [num_sent_wgts];
+    send_dst_indexes = new long [num_sent_wgts];
+    send_wgts_values = new double [num_sent_wgts];
+    for (i = 0; i < num_procs_in_file_read_comm; i ++)
+        send_pos[i] = send_displs[i];
+    for (i = 0; i < slab_size; i ++) {
+        owner = query_owners[query_pos[i]];
+        if (owner == -1)
+            continue;
+        send_src_indexes[send_pos[owner]] = temp_wgts_src_indexes[i];
+        send_dst_indexes[send_pos[owner]] = temp_wgts_dst_indexes[i];
+        send_wgts_values[send_pos[owner]] = slab_wgts_values[i];
+        send_pos[owner] ++;
+    }
+    delete [] temp_wgts_src_indexes;
+    delete [] temp_wgts_dst_indexes;
+    delete [] slab_wgts_values;
+    delete [] query_owners;
+    delete [] query_pos;
+
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, file_read_comm);
+    recv_displs[0] = 0;
+    for (i = 1; i < num_procs_in_file_read_comm; i ++)
+        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+    num_local_wgts = recv_displs[num_procs_in_file_read_comm-1] + recv_counts[num_procs_in_file_read_comm-1];
+    wgts_src_indexes = new long [num_local_wgts];
+    wgts_dst_indexes = new long [num_local_wgts];
+    wgts_values = new double [num_local_wgts];
+    MPI_Alltoallv(send_src_indexes, send_counts, send_displs, MPI_LONG, wgts_src_indexes, recv_counts, recv_displs, MPI_LONG, file_read_comm);
+    MPI_Alltoallv(send_dst_indexes, send_counts, send_displs, MPI_LONG, wgts_dst_indexes, recv_counts, recv_displs, MPI_LONG, file_read_comm);
+    MPI_Alltoallv(send_wgts_values, send_counts, send_displs, MPI_DOUBLE, wgts_values, recv_counts, recv_displs, MPI_DOUBLE, file_read_comm);
+    num_wgts = num_local_wgts;
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Load remapping weight file %s in parallel: read %ld of %ld weights starting from %ld, and keep %ld weights of the local target cells", wgt_file_name, slab_size, num_global_wgts, slab_start, num_local_wgts);
+
+    delete [] send_src_indexes;
+    delete [] send_dst_indexes;
+    delete [] send_wgts_values;
+    delete [] send_counts;
+    delete [] send_displs;
+    delete [] send_pos;
+    delete [] recv_counts;
+    delete [] recv_displs;
+
+    return true;
+}
+
+
 void H2D_remapping_wgt_file_info::clean()
 {
     if (wgts_src_indexes != NULL) {
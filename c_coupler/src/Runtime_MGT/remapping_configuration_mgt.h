@@ -44,6 +44,8 @@ class H2D_remapping_wgt_file_info
         double *wgts_values;
         std::vector<std::pair<Original_grid_info*, Original_grid_info*> > matched_grid_pair;
 
+        bool read_remapping_weights_in_parallel(int, IO_netcdf*, MPI_Comm, int, int);
+
     public:
         H2D_remapping_wgt_file_info(const char*);
         H2D_remapping_wgt_file_info(const char*, long*);
@@ -23,24 +23,86 @@ template<typename T> void template_cumulate_or_average(T* dst, const T* src, con
         for (int i = 0; i < length; i++)
             dst[i] = src[i];
     } 
-    else {
+    else if (!do_average) {
         for (int i = 0; i < length; i++)
             dst[i] += src[i];
     }
-    if (do_average && computing_count != 1) {
-        /// a trick
+    else {
+        /// a trick: accumulate and average in one pass
         T frac = 1 / ((T)computing_count);
         if (frac == 0) {
             /// not a float number
             for (int i = 0; i < length; i++)
-                dst[i] = dst[i] / computing_count;
+                dst[i] = (dst[i] + src[i]) / computing_count;
 
         } else {
             /// float number
             for (int i = 0; i < length; i++)
-                dst[i] = dst[i] * frac;
+                dst[i] = (dst[i] + src[i]) * frac;
+        }
+    }
+}
+
+
+template<typename T1, typename T2> void template_cumulate_average_and_transform(T1* dst, const T1* src, T2* transformed_dst, const int length, const int computing_count)
+{
+    if (computing_count == 1) {
+        for (int i = 0; i < length; i++) {
+            dst[i] = src[i];
+            transformed_dst[i] = (T2) src[i];
         }
     }
+    else {
+        T1 frac = 1 / ((T1)computing_count);
+        if (frac == 0) {
+            for (int i = 0; i < length; i++) {
+                dst[i] = (dst[i] + src[i]) / computing_count;
+                transformed_dst[i] = (T2) dst[i];
+            }
+        }
+        else {
+            for (int i = 0; i < length; i++) {
+                dst[i] = (dst[i] + src[i]) * frac;
+                transformed_dst[i] = (T2) dst[i];
+            }
+        }
+    }
+}
+
+
+template<typename T> void cumulate_or_average_kernel(void *dst, const void *src, const int length, const int computing_count, const bool do_average)
+{
+    template_cumulate_or_average<T>((T*) dst, (const T*) src, length, computing_count, do_average);
+}
+
+
+template<typename T1, typename T2> void cumulate_average_and_transform_kernel(void *dst, const void *src, void *transformed_dst, const int length, const int computing_count)
+{
+    template_cumulate_average_and_transform<T1,T2>((T1*) dst, (const T1*) src, (T2*) transformed_dst, length, computing_count);
+}
+
+
+static Cumulate_average_kernel select_cumulate_average_kernel(const char *data_type)
+{
+	if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
+		return cumulate_or_average_kernel<float>;
+	if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
+		return cumulate_or_average_kernel<double>;
+	if (words_are_the_same(data_type, DATA_TYPE_INT))
+		return cumulate_or_average_kernel<int>;
+	return NULL;
+}
+
+
+static Cumulate_average_transform_kernel select_cumulate_average_transform_kernel(const char *data_type, const char *transformed_data_type)
+{
+	if (words_are_the_same(data_type, DATA_TYPE_DOUBLE) && words_are_the_same(transformed_data_type, DATA_TYPE_FLOAT))
+		return cumulate_average_and_transform_kernel<double,float>;
+	if (words_are_the_same(data_type, DATA_TYPE_INT) && words_are_the_same(transformed_data_type, DATA_TYPE_SHORT))
+		return cumulate_average_and_transform_kernel<int,short>;
+	if (words_are_the_same(data_type, DATA_TYPE_INT) && words_are_the_same(transformed_data_type, DATA_TYPE_BOOL))
+		return cumulate_average_and_transform_kernel<int,bool>;
+	return NULL;
 }
 
 
@@ -55,6 +117,9 @@ Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm(Connectio
     cumulate_average_field->num_elements_in_field = field_src->get_size_of_field();
     cumulate_average_field->field_data_type = field_src->get_data_type();
     cumulate_average_field->current_computing_count = 0;
+    cumulate_average_field->kernel = select_cumulate_average_kernel(cumulate_average_field->field_data_type);
+    fused_datatype_transformer = NULL;
+    fused_kernel = NULL;
 	EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, field_src->get_decomp_id() == field_dst->get_decomp_id(), "Software error in Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm");
 	if (field_src->get_field_data()->get_coord_value_grid() != field_dst->get_field_data()->get_coord_value_grid()) {
 		cumulate_average_field->original_mem_info_src = field_src;
@@ -67,15 +132,16 @@ Runtime_cumulate_average_algorithm::Runtime_cumulate_average_algorithm(Connectio
 }
 
 
-void Runtime_cumulate_average_algorithm::handler_cumulate_or_average(const char *data_type, void *data_dst, const void *data_src, const int length, const int computing_count, const bool do_average)
+void Runtime_cumulate_average_algorithm::fuse_datatype_transformation(Runtime_datatype_transformer *datatype_transformer)
 {
-	if (words_are_the_same(data_type, DATA_TYPE_FLOAT))
-		template_cumulate_or_average<float>((float *) data_dst, (float *) data_src, length, computing_count, do_average);
-	else if (words_are_the_same(data_type, DATA_TYPE_DOUBLE))
-		template_cumulate_or_average<double>((double *) data_dst, (double *) data_src, length, computing_count, do_average);
-	else if (words_are_the_same(data_type, DATA_TYPE_INT))
-		template_cumulate_or_average<int>((int *) data_dst, (int *) data_src, length, computing_count, do_average);
-	else EXECUTION_REPORT(REPORT_ERROR, -1, false, "error data type in cumulate_average algorithm\n"); 
+    if (cumulate_average_fields.size() != 1 || datatype_transformer->get_src_field() != cumulate_average_fields[0]->mem_info_dst || datatype_transformer->get_dst_field()->get_num_chunks() != cumulate_average_fields[0]->mem_info_src->get_num_chunks())
+        return;
+
+    fused_kernel = select_cumulate_average_transform_kernel(cumulate_average_fields[0]->field_data_type, datatype_transformer->get_dst_field()->get_data_type());
+    if (fused_kernel != NULL) {
+        fused_datatype_transformer = datatype_transformer;
+        EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "fuse the average of field \"%s\" with the data type transformation from %s to %s", cumulate_average_fields[0]->mem_info_dst->get_field_name(), cumulate_average_fields[0]->field_data_type, datatype_transformer->get_dst_field()->get_data_type());
+    }
 }
 
 
@@ -112,12 +178,27 @@ void Runtime_cumulate_average_algorithm::cumulate_or_average(bool do_average)
     
     for (int i = 0; i < cumulate_average_fields.size(); i ++) {
         cumulate_average_fields[i]->current_computing_count ++;
+		EXECUTION_REPORT(REPORT_ERROR, -1, cumulate_average_fields[i]->kernel != NULL, "error data type in cumulate_average algorithm\n"); 
 		int num_chunks = cumulate_average_fields[i]->mem_info_src->get_num_chunks();
-		if (num_chunks == 0)
-			handler_cumulate_or_average(cumulate_average_fields[i]->field_data_type, cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count, do_average);
-		else for (int j = 0; j < num_chunks; j ++) {
-			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j), "Software error Runtime_cumulate_average_algorithm::cumulate_or_average");
-			handler_cumulate_or_average(cumulate_average_fields[i]->field_data_type, cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count, do_average);
+		if (do_average && fused_datatype_transformer != NULL) {
+			Field_mem_info *transformed_field = fused_datatype_transformer->get_dst_field();
+			if (num_chunks == 0)
+				fused_kernel(cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), transformed_field->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count);
+			else for (int j = 0; j < num_chunks; j ++) {
+				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j) && cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == transformed_field->get_chunk_data_buf_size(j), "Software error Runtime_cumulate_average_algorithm::cumulate_or_average");
+				fused_kernel(cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), transformed_field->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count);
+			}
+			fused_datatype_transformer->set_src_fields_transformed(true);
+		}
+		else {
+			if (fused_datatype_transformer != NULL)
+				fused_datatype_transformer->set_src_fields_transformed(false);
+			if (num_chunks == 0)
+				cumulate_average_fields[i]->kernel(cumulate_average_fields[i]->mem_info_dst->get_data_buf(), cumulate_average_fields[i]->mem_info_src->get_data_buf(), cumulate_average_fields[i]->num_elements_in_field, cumulate_average_fields[i]->current_computing_count, do_average);
+			else for (int j = 0; j < num_chunks; j ++) {
+				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j) == cumulate_average_fields[i]->mem_info_dst->get_chunk_data_buf_size(j), "Software error Runtime_cumulate_average_algorithm::cumulate_or_average");
+				cumulate_average_fields[i]->kernel(cumulate_average_fields[i]->mem_info_dst->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_buf(j), cumulate_average_fields[i]->mem_info_src->get_chunk_data_buf_size(j), cumulate_average_fields[i]->current_computing_count, do_average);
+			}
 		}
         if (do_average) {
             EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "do average at computing count is %d", cumulate_average_fields[i]->current_computing_count);
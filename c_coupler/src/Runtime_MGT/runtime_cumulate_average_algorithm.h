@@ -14,12 +14,17 @@
 #include "memory_mgt.h"
 #include "common_utils.h"
 #include "restart_mgt.h"
+#include "runtime_datatype_transformer.h"
 #include <vector>
 
 
 class Connection_coupling_procedure;
 
 
+typedef void (*Cumulate_average_kernel)(void *, const void *, const int, const int, const bool);
+typedef void (*Cumulate_average_transform_kernel)(void *, const void *, void *, const int, const int);
+
+
 struct cumulate_average_field_info
 {
     int num_elements_in_field;
@@ -29,6 +34,7 @@ struct cumulate_average_field_info
     Field_mem_info *mem_info_dst;
     Coupling_timer *timer;
     int current_computing_count;
+    Cumulate_average_kernel kernel;
 };
 
 
@@ -38,12 +44,14 @@ class Runtime_cumulate_average_algorithm
         int comp_id;
         std::vector<cumulate_average_field_info*> cumulate_average_fields;
         Connection_coupling_procedure *coupling_procedure;
+        Runtime_datatype_transformer *fused_datatype_transformer;
+        Cumulate_average_transform_kernel fused_kernel;
         void cumulate_or_average(bool);
-		void handler_cumulate_or_average(const char *, void *, const void *, const int, const int, const bool);
         
     public:
         Runtime_cumulate_average_algorithm(Connection_coupling_procedure *, Field_mem_info*, Field_mem_info*);
         ~Runtime_cumulate_average_algorithm();
+        void fuse_datatype_transformation(Runtime_datatype_transformer *);
         void restart_write(Restart_buffer_container*, const char *);
         void restart_read(Restart_buffer_container*, const char *);
         bool run(bool);
@@ -15,6 +15,7 @@ Runtime_datatype_transformer::Runtime_datatype_transformer(Field_mem_info *src_f
 {
     src_fields.push_back(src_field);
     dst_fields.push_back(dst_field);
+    src_fields_transformed = false;
 }
 
 
@@ -91,7 +92,9 @@ void Runtime_datatype_transformer::transform_fields_datatype()
 		EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, src_fields[i]->get_num_chunks() == dst_fields[i]->get_num_chunks(), "Software error in Runtime_datatype_transformer::transform_fields_datatype");
         data_type_src = src_fields[i]->get_field_data()->get_grid_data_field()->data_type_in_application;
         data_type_dst = dst_fields[i]->get_field_data()->get_grid_data_field()->data_type_in_application;
-		if (src_fields[i]->get_num_chunks() == 0)
+		if (src_fields_transformed)
+			;	/// the dst values have been written by the fused cumulate/average kernel
+		else if (src_fields[i]->get_num_chunks() == 0)
 			handler_datatype_transformation_of_array(data_type_dst, data_type_src, dst_fields[i]->get_data_buf(), src_fields[i]->get_data_buf(), src_fields[i]->get_field_data()->get_grid_data_field()->required_data_size);
 		else for (int j = 0; j < src_fields[i]->get_num_chunks(); j ++) {
 			EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, dst_fields[i]->get_chunk_data_buf_size(j) == src_fields[i]->get_chunk_data_buf_size(j), "Software error in Runtime_datatype_transformer::transform_fields_datatype");
@@ -99,5 +102,6 @@ void Runtime_datatype_transformer::transform_fields_datatype()
 		}
 		dst_fields[i]->check_field_sum(report_internal_log_enabled, true, "(dst value) after data type transformation");
     }
+    src_fields_transformed = false;
 }
 
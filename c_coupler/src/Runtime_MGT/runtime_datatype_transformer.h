@@ -19,11 +19,15 @@ class Runtime_datatype_transformer
     private:
         std::vector<Field_mem_info*> src_fields;
         std::vector<Field_mem_info*> dst_fields;
+        bool src_fields_transformed;
 
     public:
-        Runtime_datatype_transformer() {}
+        Runtime_datatype_transformer() { src_fields_transformed = false; }
         Runtime_datatype_transformer(Field_mem_info*, Field_mem_info*);
         ~Runtime_datatype_transformer() {}
+        Field_mem_info *get_src_field() { return src_fields[0]; }
+        Field_mem_info *get_dst_field() { return dst_fields[0]; }
+        void set_src_fields_transformed(bool transformed) { src_fields_transformed = transformed; }
         void transform_fields_datatype();		
 		void handler_datatype_transformation_of_array(const char *, const char *, void *, const void *, const int);
         bool run(bool);
@@ -17,6 +17,21 @@
 
 
 
+static bool *generate_H2D_grid_decomp_mask(Decomp_info *decomp_info)
+{
+    bool *decomp_mask = new bool [decomp_info->get_num_global_cells()];
+
+
+    for (int i = 0; i < decomp_info->get_num_global_cells(); i ++)
+        decomp_mask[i] = false;
+    for (int i = 0; i < decomp_info->get_num_local_cells(); i ++)
+        if (decomp_info->get_local_cell_global_indx()[i] != CCPL_NULL_INT)
+            decomp_mask[decomp_info->get_local_cell_global_indx()[i]] = true;
+
+    return decomp_mask;
+}
+
+
 Runtime_remapping_weights::Runtime_remapping_weights()
 {
     src_comp_full_name = NULL;
@@ -123,7 +138,14 @@ Runtime_remapping_weights::Runtime_remapping_weights(const char *src_comp_full_n
     sprintf(remap_weight_name, "weights_%lx_%s(%s)_to_%s(%s)", remapping_setting->calculate_checksum(), src_original_grid->get_grid_name(), src_comp_full_name, dst_original_grid->get_grid_name(), dst_comp_full_name);
     if (H2D_remapping_weight_file != NULL) {
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_PROGRESS, dst_original_grid->get_comp_id(), true, "The remapping weight file \"%s\" will be used for data remapping from the horizontal grid \"%s\" (of the component model \"%s\") to the horizontal grid \"%s\" (of the component model \"%s\").", H2D_remapping_weight_file->get_wgt_file_name(), src_original_grid->get_grid_name(), src_comp_full_name, dst_original_grid->get_grid_name(), dst_comp_full_name);
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, H2D_grid_decomp_mask == NULL, "Software error in Runtime_remapping_weights::Runtime_remapping_weights");
+        if (dst_decomp_info != NULL)
+            H2D_grid_decomp_mask = generate_H2D_grid_decomp_mask(dst_decomp_info);
         sequential_remapping_weights = new Remap_weight_of_strategy_class(remap_weight_name, remapping_strategy, src_original_grid->get_original_CoR_grid()->get_ordered_similar_grid_under_V3D(), dst_original_grid->get_original_CoR_grid()->get_ordered_similar_grid_under_V3D(), H2D_remapping_weight_file->get_wgt_file_name(), true, comp_comm_group_mgt_mgr->search_global_node(dst_comp_full_name)->get_comp_id());
+        if (H2D_grid_decomp_mask != NULL) {
+            delete [] H2D_grid_decomp_mask;
+            H2D_grid_decomp_mask = NULL;
+        }
         if (src_original_grid->is_H2D_grid()) 
             set_H2D_grids_area(H2D_remapping_weight_file->get_src_area(), H2D_remapping_weight_file->get_dst_area(), src_original_grid->get_original_CoR_grid()->get_grid_size(), dst_original_grid->get_original_CoR_grid()->get_grid_size());
         H2D_remapping_weight_file->clean();
@@ -131,12 +153,7 @@ Runtime_remapping_weights::Runtime_remapping_weights(const char *src_comp_full_n
     else if (dst_original_grid->get_H2D_sub_CoR_grid() != NULL) {    
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_PROGRESS, dst_original_grid->get_comp_id(), true, "No remapping weight file has been specified for data remapping from the horizontal sub grid of \"%s\" (of the component model \"%s\") to the horizontal sub grid of \"%s\" (of the component model \"%s\"). So the remapping weights will be generated by C-Coupler", src_original_grid->get_grid_name(), src_comp_full_name, dst_original_grid->get_grid_name(), dst_comp_full_name);
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, H2D_grid_decomp_mask == NULL, "Software error in Runtime_remapping_weights::Runtime_remapping_weights");
-        H2D_grid_decomp_mask = new bool [dst_decomp_info->get_num_global_cells()];
-        for (int i = 0; i < dst_decomp_info->get_num_global_cells(); i ++)
-            H2D_grid_decomp_mask[i] = false;
-        for (int i = 0; i < dst_decomp_info->get_num_local_cells(); i ++)
-        	if (dst_decomp_info->get_local_cell_global_indx()[i] != CCPL_NULL_INT)
-                H2D_grid_decomp_mask[dst_decomp_info->get_local_cell_global_indx()[i]] = true;
+        H2D_grid_decomp_mask = generate_H2D_grid_decomp_mask(dst_decomp_info);
         sequential_remapping_weights = new Remap_weight_of_strategy_class(remap_weight_name, remapping_strategy, src_original_grid->get_original_CoR_grid()->get_ordered_similar_grid_under_V3D(), dst_original_grid->get_original_CoR_grid()->get_ordered_similar_grid_under_V3D(), NULL, true, comp_comm_group_mgt_mgr->search_global_node(dst_comp_full_name)->get_comp_id());
         delete [] H2D_grid_decomp_mask;
         H2D_grid_decomp_mask = NULL;
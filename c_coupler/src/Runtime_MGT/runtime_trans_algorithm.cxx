@@ -130,9 +130,18 @@ Runtime_trans_algorithm::Runtime_trans_algorithm(bool send_or_receive, int num_t
     sender_time_has_matched = false;
 
 #ifndef USE_ONE_SIDED_MPI
-    request = new MPI_Request[num_remote_procs];
+    pipelined_transfer = pipelined_field_transfer > 0 && num_transfered_fields > 1;
+    request = new MPI_Request[pipelined_transfer? num_remote_procs*num_transfered_fields : num_remote_procs];
     is_first_run = true;
+#else
+    pipelined_transfer = false;
 #endif
+    fields_transfer_size_with_remote_procs = new int [num_transfered_fields*num_remote_procs];
+    fields_transfer_displs_with_remote_procs = new int [num_transfered_fields*num_remote_procs];
+    fields_received = new bool [num_transfered_fields];
+    fields_segments_posted = false;
+    received_tags_checked = false;
+    fields_receive_buffer_index = -1;
     transfer_size_with_remote_procs = new int [num_remote_procs];
     send_displs_in_remote_procs = new int [num_remote_procs];
     recv_displs_in_current_proc = new int [num_remote_procs];
@@ -276,6 +285,9 @@ Runtime_trans_algorithm::~Runtime_trans_algorithm()
     delete [] transfer_size_with_remote_procs;
     delete [] send_displs_in_remote_procs;
     delete [] recv_displs_in_current_proc;
+    delete [] fields_transfer_size_with_remote_procs;
+    delete [] fields_transfer_displs_with_remote_procs;
+    delete [] fields_received;
     delete [] remote_proc_ranks_in_union_comm;
     delete [] temp_receive_data_buffer;
 	delete [] field_total_dim_size_after_H2D;
@@ -353,46 +365,24 @@ bool Runtime_trans_algorithm::is_remote_data_buf_ready(bool bypass_timer)
 }
 
 
-void Runtime_trans_algorithm::receive_data_in_temp_buffer()
+bool Runtime_trans_algorithm::is_receive_postponed()
 {
-    bool is_ready = true;
-    double time1, time2, time3;
-
-
-    if (index_remote_procs_with_common_data.size() == 0)
-        return;
-
     if (timer_not_bypassed && last_history_receive_buffer_index != -1) {
         int comp_min_remote_lag_seconds = comp_node->get_min_remote_lag_seconds();
         long current_receiver_full_seconds = ((long)time_mgr->get_current_num_elapsed_day())*86400 + time_mgr->get_current_second();
         long current_sender_full_seconds = time_mgr->get_elapsed_day_from_full_time(current_receive_field_sender_time%((long)10000000000000000))*86400 + (current_receive_field_sender_time%((long)100000));
         if (current_sender_full_seconds + 2*comp_min_remote_lag_seconds > current_receiver_full_seconds)
-            return;
+            return true;
     }
 
-#ifndef USE_ONE_SIDED_MPI
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
-    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
-        int remote_proc_index = index_remote_procs_with_common_data[i];
-        if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
-            continue;
-        data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
-        int remote_proc_id = remote_proc_ranks_in_union_comm[remote_proc_index];
-        MPI_Irecv((char *)data_buf, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[i]);
-    }    
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
-    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
-    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
-        int remote_proc_index = index_remote_procs_with_common_data[i];
-        if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
-            continue;
-        MPI_Status state;
-        MPI_Wait(&request[i], &state);
-    }
-    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
-#endif
+    return false;
+}
+
+
+bool Runtime_trans_algorithm::check_received_tags()
+{
+    bool is_ready = true;
 
-    wtime(&time1);
 
 #ifdef USE_ONE_SIDED_MPI
     MPI_Win_lock(MPI_LOCK_EXCLUSIVE, current_proc_id_union_comm, 0, data_win);
@@ -414,14 +404,14 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
 #ifndef USE_ONE_SIDED_MPI
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, false, "Software error1 in MPI_send/recv implementation in Runtime_trans_algorithm::receive_data_in_temp_buffer");
 #endif
-        return;
+        return false;
     }
 
     if (last_receive_field_sender_time == current_receive_field_sender_time) {
 #ifndef USE_ONE_SIDED_MPI
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, false, "Software error2 in MPI_send/recv implementation in Runtime_trans_algorithm::receive_data_in_temp_buffer");
 #endif
-        return;
+        return false;
     }
 
     for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
@@ -438,11 +428,12 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
         }
     }
 
-#ifdef USE_ONE_SIDED_MPI
-    wtime(&time2);    
-    local_comp_node->get_performance_timing_mgr()->performance_timing_add(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_QUERRY, -1, remote_comp_full_name, time2-time1);
-#endif    
+    return true;
+}
 
+
+int Runtime_trans_algorithm::get_empty_history_receive_buffer()
+{
     int empty_history_receive_buffer_index = -1;
     if (last_history_receive_buffer_index != -1) {
         for (int i = 0; i < history_receive_fields_mem.size(); i ++) {
@@ -495,6 +486,52 @@ void Runtime_trans_algorithm::receive_data_in_temp_buffer()
     history_receive_usage_time[empty_history_receive_buffer_index] = current_receive_field_usage_time;
     last_receive_field_sender_time = current_receive_field_sender_time;
 
+    return empty_history_receive_buffer_index;
+}
+
+
+void Runtime_trans_algorithm::receive_data_in_temp_buffer()
+{
+    double time1, time2, time3;
+
+
+    if (index_remote_procs_with_common_data.size() == 0 || is_receive_postponed())
+        return;
+
+#ifndef USE_ONE_SIDED_MPI
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
+    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
+        int remote_proc_index = index_remote_procs_with_common_data[i];
+        if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
+            continue;
+        data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
+        int remote_proc_id = remote_proc_ranks_in_union_comm[remote_proc_index];
+        MPI_Irecv((char *)data_buf, 4*sizeof(long)+transfer_size_with_remote_procs[remote_proc_index], MPI_CHAR, remote_proc_id, comm_tag, union_comm, &request[i]);
+    }    
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
+        int remote_proc_index = index_remote_procs_with_common_data[i];
+        if (transfer_size_with_remote_procs[remote_proc_index] == 0) 
+            continue;
+        MPI_Status state;
+        MPI_Wait(&request[i], &state);
+    }
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+#endif
+
+    wtime(&time1);
+
+    if (!check_received_tags())
+        return;
+
+#ifdef USE_ONE_SIDED_MPI
+    wtime(&time2);    
+    local_comp_node->get_performance_timing_mgr()->performance_timing_add(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_QUERRY, -1, remote_comp_full_name, time2-time1);
+#endif    
+
+    int empty_history_receive_buffer_index = get_empty_history_receive_buffer();
+
 #ifdef USE_ONE_SIDED_MPI
     MPI_Win_lock(MPI_LOCK_SHARED, current_proc_id_union_comm, 0, data_win);
 #endif
@@ -562,7 +599,9 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
 #ifndef USE_ONE_SIDED_MPI
     comp_comm_group_mgt_mgr->get_global_node_of_local_comp(comp_id,false,"")->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND_WAIT, -1, remote_comp_full_name);
     if (!is_first_run) {
-        for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
+        if (pipelined_transfer)
+            MPI_Waitall(index_remote_procs_with_common_data.size()*num_transfered_fields, request, MPI_STATUSES_IGNORE);
+        else for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
             int remote_proc_index = index_remote_procs_with_common_data[i];
             MPI_Status state;
             MPI_Wait(&request[i], &state);
@@ -595,7 +634,9 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
     long current_full_time = time_mgr->get_current_full_time();
     int offset = 0;
     //for (int i = 0; i < num_remote_procs; i ++) {
-    for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
+    if (pipelined_transfer)
+        send_fields_segments(bypass_timer, current_full_time);
+    else for (int i = 0; i < index_remote_procs_with_common_data.size(); i ++) {
         int remote_proc_index = index_remote_procs_with_common_data[i];
         //if (transfer_size_with_remote_procs[remote_proc_index] == 0) continue;
 
@@ -612,17 +653,7 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
                 else pack_MD_data(remote_proc_index, j, &offset);
             }
 
-        tag_buf = (long *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
-        if (bypass_timer) {
-            tag_buf[0] = current_full_time + (bypass_counter%8)*((long)10000000000000000);
-            tag_buf[1] = -999;
-        }
-        else {
-            tag_buf[0] = current_full_time;
-            tag_buf[1] = current_remote_fields_time;
-        }
-        tag_buf[2] = (long) time_mgr->get_runtype_mark();
-        tag_buf[3] = time_mgr->get_restart_full_time();
+        fill_send_tags(remote_proc_index, bypass_timer, current_full_time);
 
         int remote_proc_id = remote_proc_ranks_in_union_comm[remote_proc_index];
 
@@ -649,11 +680,183 @@ bool Runtime_trans_algorithm::send(bool bypass_timer)
 }
 
 
+void Runtime_trans_algorithm::fill_send_tags(int remote_proc_index, bool bypass_timer, long current_full_time)
+{
+    tag_buf = (long *) (total_buf + recv_displs_in_current_proc[remote_proc_index]);
+    if (bypass_timer) {
+        tag_buf[0] = current_full_time + (bypass_counter%8)*((long)10000000000000000);
+        tag_buf[1] = -999;
+    }
+    else {
+        tag_buf[0] = current_full_time;
+        tag_buf[1] = current_remote_fields_time;
+    }
+    tag_buf[2] = (long) time_mgr->get_runtype_mark();
+    tag_buf[3] = time_mgr->get_restart_full_time();
+}
+
+
+void Runtime_trans_algorithm::send_fields_segments(bool bypass_timer, long current_full_time)
+{
+    int num_procs_with_common_data = index_remote_procs_with_common_data.size();
+
+
+    for (int i = 0; i < num_procs_with_common_data; i ++)
+        fill_send_tags(index_remote_procs_with_common_data[i], bypass_timer, current_full_time);
+
+    for (int j = 0; j < num_transfered_fields; j ++) {
+        for (int i = 0; i < num_procs_with_common_data; i ++) {
+            int remote_proc_index = index_remote_procs_with_common_data[i];
+            if (transfer_size_with_remote_procs[remote_proc_index] == 0) {
+                request[j*num_procs_with_common_data+i] = MPI_REQUEST_NULL;
+                continue;
+            }
+            int offset = fields_transfer_displs_with_remote_procs[j*num_remote_procs+remote_proc_index];
+            int segment_size = fields_transfer_size_with_remote_procs[j*num_remote_procs+remote_proc_index];
+            data_buf = (void *) (total_buf + recv_displs_in_current_proc[remote_proc_index] + 4*sizeof(long));
+            if (fields_routers[j]->get_num_dimensions() == 0)
+                memcpy((char *)data_buf + offset, fields_data_buffers[j], segment_size);
+            else pack_MD_data(remote_proc_index, j, &offset);
+            char *segment_buf = (char *) data_buf + fields_transfer_displs_with_remote_procs[j*num_remote_procs+remote_proc_index];
+            if (j == 0) {
+                segment_buf -= 4*sizeof(long);
+                segment_size += 4*sizeof(long);
+            }
+            MPI_Isend(segment_buf, segment_size, MPI_CHAR, remote_proc_ranks_in_union_comm[remote_proc_index], comm_tag, union_comm, &request[j*num_procs_with_common_data+i]);
+        }
+    }
+}
+
+
+void Runtime_trans_algorithm::copy_received_field(int field_index)
+{
+    if (!for_halo_exchange) {
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_mem[field_index]->get_num_chunks() == history_receive_fields_mem[last_history_receive_buffer_index][field_index]->get_num_chunks(), "Software error in Runtime_trans_algorithm::recv");
+        if (fields_mem[field_index]->get_num_chunks() == 0)
+            memcpy(fields_mem[field_index]->get_data_buf(), history_receive_fields_mem[last_history_receive_buffer_index][field_index]->get_data_buf(), fields_mem[field_index]->get_size_of_field()*get_data_type_size(fields_mem[field_index]->get_data_type()));
+        else {
+            for (int k = 0; k < fields_mem[field_index]->get_num_chunks(); k ++) {
+                EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_mem[field_index]->get_chunk_data_buf_size(k) == history_receive_fields_mem[last_history_receive_buffer_index][field_index]->get_chunk_data_buf_size(k), "Software error in Runtime_trans_algorithm::recv");
+                memcpy(fields_mem[field_index]->get_chunk_buf(k), history_receive_fields_mem[last_history_receive_buffer_index][field_index]->get_chunk_buf(k), fields_mem[field_index]->get_chunk_data_buf_size(k)*get_data_type_size(fields_mem[field_index]->get_data_type()));
+            }
+        }
+    }
+}
+
+
+void Runtime_trans_algorithm::start_receiving_fields(bool bypass_timer)
+{
+    int num_procs_with_common_data = index_remote_procs_with_common_data.size();
+
+
+    if (!bypass_timer)
+        timer_not_bypassed = true;
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Proc %d begins to receive data field by field from component \"%s\": %ld %d %d", current_proc_id_union_comm, remote_comp_full_name, current_remote_fields_time, comm_tag, data_buf_size);
+
+    for (int j = 0; j < num_transfered_fields; j ++)
+        fields_received[j] = false;
+    fields_segments_posted = false;
+    received_tags_checked = false;
+    if (num_procs_with_common_data == 0)
+        return;
+
+    preprocess();
+    if (is_receive_postponed())
+        return;
+
+    local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
+    for (int j = 0; j < num_transfered_fields; j ++) {
+        for (int i = 0; i < num_procs_with_common_data; i ++) {
+            int remote_proc_index = index_remote_procs_with_common_data[i];
+            if (transfer_size_with_remote_procs[remote_proc_index] == 0) {
+                request[j*num_procs_with_common_data+i] = MPI_REQUEST_NULL;
+                continue;
+            }
+            char *segment_buf = total_buf + recv_displs_in_current_proc[remote_proc_index] + 4*sizeof(long) + fields_transfer_displs_with_remote_procs[j*num_remote_procs+remote_proc_index];
+            int segment_size = fields_transfer_size_with_remote_procs[j*num_remote_procs+remote_proc_index];
+            if (j == 0) {
+                segment_buf -= 4*sizeof(long);
+                segment_size += 4*sizeof(long);
+            }
+            MPI_Irecv(segment_buf, segment_size, MPI_CHAR, remote_proc_ranks_in_union_comm[remote_proc_index], comm_tag, union_comm, &request[j*num_procs_with_common_data+i]);
+        }
+    }
+    local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV, -1, remote_comp_full_name);
+    fields_segments_posted = true;
+}
+
+
+void Runtime_trans_algorithm::receive_field(int field_index)
+{
+    int num_procs_with_common_data = index_remote_procs_with_common_data.size();
+
+
+    if (fields_received[field_index])
+        return;
+
+    if (fields_segments_posted) {
+        local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+        if (!received_tags_checked)
+            MPI_Waitall(num_procs_with_common_data, request, MPI_STATUSES_IGNORE);
+        MPI_Waitall(num_procs_with_common_data, request+field_index*num_procs_with_common_data, MPI_STATUSES_IGNORE);
+        local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
+        if (!received_tags_checked) {
+            check_received_tags();
+            fields_receive_buffer_index = get_empty_history_receive_buffer();
+            received_tags_checked = true;
+        }
+        for (int i = 0; i < num_procs_with_common_data; i ++) {
+            int remote_proc_index = index_remote_procs_with_common_data[i];
+            if (transfer_size_with_remote_procs[remote_proc_index] == 0)
+                continue;
+            int offset = fields_transfer_displs_with_remote_procs[field_index*num_remote_procs+remote_proc_index];
+            char *proc_data_buf = total_buf + recv_displs_in_current_proc[remote_proc_index] + 4*sizeof(long);
+            if (fields_routers[field_index]->get_num_dimensions() == 0)
+                memcpy(history_receive_fields_mem[fields_receive_buffer_index][field_index]->get_data_buf(), proc_data_buf + offset, fields_data_type_sizes[field_index]*fields_mem[field_index]->get_size_of_field());
+            else unpack_MD_data(proc_data_buf, remote_proc_index, field_index, history_receive_fields_mem[fields_receive_buffer_index][field_index], &offset);
+        }
+    }
+
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, num_procs_with_common_data == 0 || last_history_receive_buffer_index >= 0, "Software error with last_history_receive_buffer_index: %d", last_history_receive_buffer_index);
+    if (num_procs_with_common_data > 0)
+        copy_received_field(field_index);
+    fields_mem[field_index]->check_field_sum(report_internal_log_enabled, true, "after receiving data");
+    fields_mem[field_index]->define_field_values(false);
+    fields_received[field_index] = true;
+}
+
+
+void Runtime_trans_algorithm::finish_receiving_fields(bool bypass_timer)
+{
+    for (int j = 0; j < num_transfered_fields; j ++)
+        receive_field(j);
+
+    if (index_remote_procs_with_common_data.size() > 0)
+        last_receive_sender_time = history_receive_sender_time[last_history_receive_buffer_index];
+    else if (bypass_timer)
+        last_receive_sender_time = (bypass_counter%8)*((long)10000000000000000);
+    else last_receive_sender_time = current_remote_fields_time;
+
+    if (index_remote_procs_with_common_data.size() > 0) {
+        history_receive_buffer_status[last_history_receive_buffer_index] = false;
+        last_history_receive_buffer_index = (last_history_receive_buffer_index+1) % history_receive_buffer_status.size();
+    }
+
+    EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "Finish receiving data field by field from component \"%s\" at the remote model time %ld vs %ld", remote_comp_full_name, last_receive_sender_time, current_remote_fields_time);
+}
+
+
 bool Runtime_trans_algorithm::recv(bool bypass_timer)
 {
     bool received_data_ready = false;
     
 
+    if (pipelined_transfer) {
+        start_receiving_fields(bypass_timer);
+        finish_receiving_fields(bypass_timer);
+        return true;
+    }
+
 #ifdef USE_ONE_SIDED_MPI
     local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, remote_comp_full_name);
 #endif
@@ -675,18 +878,8 @@ bool Runtime_trans_algorithm::recv(bool bypass_timer)
         }
 #endif
         EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, last_history_receive_buffer_index >= 0, "Software error with last_history_receive_buffer_index: %d", last_history_receive_buffer_index);
-		if (!for_halo_exchange)
-        	for (int j = 0; j < num_transfered_fields; j ++) {
-				EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_mem[j]->get_num_chunks() == history_receive_fields_mem[last_history_receive_buffer_index][j]->get_num_chunks(), "Software error in Runtime_trans_algorithm::recv");
-				if (fields_mem[j]->get_num_chunks() == 0)
-	            	memcpy(fields_mem[j]->get_data_buf(), history_receive_fields_mem[last_history_receive_buffer_index][j]->get_data_buf(), fields_mem[j]->get_size_of_field()*get_data_type_size(fields_mem[j]->get_data_type()));
-				else {
-					for (int k = 0; k < fields_mem[j]->get_num_chunks(); k ++) {
-						EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, fields_mem[j]->get_chunk_data_buf_size(k) == history_receive_fields_mem[last_history_receive_buffer_index][j]->get_chunk_data_buf_size(k), "Software error in Runtime_trans_algorithm::recv");
-						memcpy(fields_mem[j]->get_chunk_buf(k), history_receive_fields_mem[last_history_receive_buffer_index][j]->get_chunk_buf(k), fields_mem[j]->get_chunk_data_buf_size(k)*get_data_type_size(fields_mem[j]->get_data_type()));
-					}
-				}
-        	}
+        for (int j = 0; j < num_transfered_fields; j ++)
+            copy_received_field(j);
     }
 
 	EXECUTION_REPORT_LOG(REPORT_LOG, comp_id, true, "After receiving data from component \"%s\": %ld %d", remote_comp_full_name, current_remote_fields_time, comm_tag);
@@ -731,9 +924,13 @@ void Runtime_trans_algorithm::preprocess()
     for (int i = 0; i < num_transfered_fields; i ++) {
         for (int j = 0; j < index_remote_procs_with_common_data.size(); j ++) {
             int remote_proc_index = index_remote_procs_with_common_data[j];
+            int field_transfer_size;
             if (fields_routers[i]->get_num_dimensions() == 0)
-                transfer_size_with_remote_procs[remote_proc_index] += fields_data_type_sizes[i] * fields_mem[i]->get_size_of_field();
-            else transfer_size_with_remote_procs[remote_proc_index] += fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, remote_proc_index) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
+                field_transfer_size = fields_data_type_sizes[i] * fields_mem[i]->get_size_of_field();
+            else field_transfer_size = fields_routers[i]->get_num_elements_transferred_with_remote_proc(send_or_receive, remote_proc_index) * fields_data_type_sizes[i] * field_grid_size_beyond_H2D[i];
+            fields_transfer_displs_with_remote_procs[i*num_remote_procs+remote_proc_index] = transfer_size_with_remote_procs[remote_proc_index];
+            fields_transfer_size_with_remote_procs[i*num_remote_procs+remote_proc_index] = field_transfer_size;
+            transfer_size_with_remote_procs[remote_proc_index] += field_transfer_size;
         }
     }
 }
@@ -838,3 +1035,116 @@ void Runtime_trans_algorithm::unpack_MD_data(void *data_buf, int remote_proc_ind
     }
 }
 
+
+
+Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm(Runtime_trans_algorithm *send_algorithm, Runtime_trans_algorithm *recv_algorithm)
+{
+    int *send_procs_ranks, *recv_procs_ranks;
+
+
+    EXECUTION_REPORT(REPORT_ERROR, -1, send_algorithm->send_or_receive && !recv_algorithm->send_or_receive && send_algorithm->union_comm == recv_algorithm->union_comm, "Software error in Runtime_halo_exchange_algorithm::Runtime_halo_exchange_algorithm");
+    this->send_algorithm = send_algorithm;
+    this->recv_algorithm = recv_algorithm;
+    exchange_in_progress = false;
+
+    send_algorithm->preprocess();
+    recv_algorithm->preprocess();
+    for (int i = 0; i < send_algorithm->index_remote_procs_with_common_data.size(); i ++)
+        if (send_algorithm->transfer_size_with_remote_procs[send_algorithm->index_remote_procs_with_common_data[i]] > 0)
+            send_procs_index.push_back(send_algorithm->index_remote_procs_with_common_data[i]);
+    for (int i = 0; i < recv_algorithm->index_remote_procs_with_common_data.size(); i ++)
+        if (recv_algorithm->transfer_size_with_remote_procs[recv_algorithm->index_remote_procs_with_common_data[i]] > 0)
+            recv_procs_index.push_back(recv_algorithm->index_remote_procs_with_common_data[i]);
+
+    send_procs_ranks = new int [send_procs_index.size()+1];
+    send_counts = new int [send_procs_index.size()+1];
+    send_displs = new int [send_procs_index.size()+1];
+    recv_procs_ranks = new int [recv_procs_index.size()+1];
+    recv_counts = new int [recv_procs_index.size()+1];
+    recv_displs = new int [recv_procs_index.size()+1];
+    for (int i = 0; i < send_procs_index.size(); i ++) {
+        send_procs_ranks[i] = send_algorithm->remote_proc_ranks_in_union_comm[send_procs_index[i]];
+        send_counts[i] = send_algorithm->transfer_size_with_remote_procs[send_procs_index[i]];
+        send_displs[i] = send_algorithm->recv_displs_in_current_proc[send_procs_index[i]] + 4*sizeof(long);
+    }
+    for (int i = 0; i < recv_procs_index.size(); i ++) {
+        recv_procs_ranks[i] = recv_algorithm->remote_proc_ranks_in_union_comm[recv_procs_index[i]];
+        recv_counts[i] = recv_algorithm->transfer_size_with_remote_procs[recv_procs_index[i]];
+        recv_displs[i] = recv_algorithm->recv_displs_in_current_proc[recv_procs_index[i]] + 4*sizeof(long);
+    }
+
+    MPI_Dist_graph_create_adjacent(send_algorithm->union_comm, recv_procs_index.size(), recv_procs_ranks, MPI_UNWEIGHTED, send_procs_index.size(), send_procs_ranks, MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &neighbor_comm);
+    EXECUTION_REPORT_LOG(REPORT_LOG, send_algorithm->comp_id, true, "Create the neighborhood communicator for halo exchange with %d sources and %d destinations", recv_procs_index.size(), send_procs_index.size());
+
+    delete [] send_procs_ranks;
+    delete [] recv_procs_ranks;
+}
+
+
+Runtime_halo_exchange_algorithm::~Runtime_halo_exchange_algorithm()
+{
+    delete [] send_counts;
+    delete [] send_displs;
+    delete [] recv_counts;
+    delete [] recv_displs;
+    if (neighbor_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&neighbor_comm);
+}
+
+
+void Runtime_halo_exchange_algorithm::start_exchange()
+{
+    EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, !exchange_in_progress, "Software error in Runtime_halo_exchange_algorithm::start_exchange");
+
+    for (int j = 0; j < send_algorithm->num_transfered_fields; j ++) {
+        send_algorithm->fields_mem[j]->check_field_sum(report_internal_log_enabled, true, "before sending data");
+        send_algorithm->fields_mem[j]->use_field_values("before sending data");
+    }
+
+    send_algorithm->local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND, -1, send_algorithm->remote_comp_full_name);
+    for (int i = 0; i < send_procs_index.size(); i ++) {
+        int offset = 0;
+        send_algorithm->data_buf = (void *) (send_algorithm->total_buf + send_displs[i]);
+        for (int j = 0; j < send_algorithm->num_transfered_fields; j ++) {
+            if (send_algorithm->fields_routers[j]->get_num_dimensions() == 0) {
+                memcpy((char *)send_algorithm->data_buf + offset, send_algorithm->fields_data_buffers[j], send_algorithm->fields_data_type_sizes[j]*send_algorithm->fields_mem[j]->get_size_of_field());
+                offset += send_algorithm->fields_data_type_sizes[j]*send_algorithm->fields_mem[j]->get_size_of_field();
+            }
+            else send_algorithm->pack_MD_data(send_procs_index[i], j, &offset);
+        }
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset == send_counts[i], "Software error in Runtime_halo_exchange_algorithm::start_exchange: %d vs %d", offset, send_counts[i]);
+    }
+    MPI_Ineighbor_alltoallv(send_algorithm->total_buf, send_counts, send_displs, MPI_CHAR, recv_algorithm->total_buf, recv_counts, recv_displs, MPI_CHAR, neighbor_comm, &request);
+    send_algorithm->local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_SEND, -1, send_algorithm->remote_comp_full_name);
+    exchange_in_progress = true;
+}
+
+
+void Runtime_halo_exchange_algorithm::finish_exchange()
+{
+    if (!exchange_in_progress)
+        return;
+
+    recv_algorithm->local_comp_node->get_performance_timing_mgr()->performance_timing_start(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, recv_algorithm->remote_comp_full_name);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    recv_algorithm->local_comp_node->get_performance_timing_mgr()->performance_timing_stop(TIMING_TYPE_COMMUNICATION, TIMING_COMMUNICATION_RECV_WAIT, -1, recv_algorithm->remote_comp_full_name);
+
+    for (int i = 0; i < recv_procs_index.size(); i ++) {
+        int offset = 0;
+        char *proc_data_buf = recv_algorithm->total_buf + recv_displs[i];
+        for (int j = 0; j < recv_algorithm->num_transfered_fields; j ++) {
+            if (recv_algorithm->fields_routers[j]->get_num_dimensions() == 0) {
+                memcpy(recv_algorithm->fields_mem[j]->get_data_buf(), proc_data_buf + offset, recv_algorithm->fields_data_type_sizes[j]*recv_algorithm->fields_mem[j]->get_size_of_field());
+                offset += recv_algorithm->fields_data_type_sizes[j]*recv_algorithm->fields_mem[j]->get_size_of_field();
+            }
+            else recv_algorithm->unpack_MD_data(proc_data_buf, recv_procs_index[i], j, recv_algorithm->fields_mem[j], &offset);
+        }
+        EXECUTION_REPORT_ERROR_OPTIONALLY(REPORT_ERROR, -1, offset == recv_counts[i], "Software error in Runtime_halo_exchange_algorithm::finish_exchange: %d vs %d", offset, recv_counts[i]);
+    }
+
+    for (int j = 0; j < recv_algorithm->num_transfered_fields; j ++) {
+        recv_algorithm->fields_mem[j]->check_field_sum(report_internal_log_enabled, true, "after receiving data");
+        recv_algorithm->fields_mem[j]->define_field_values(false);
+    }
+    exchange_in_progress = false;
+}
@@ -20,6 +20,7 @@
 class Runtime_trans_algorithm
 {
     private:
+        friend class Runtime_halo_exchange_algorithm;
         int num_remote_procs_related;
         int remote_proc_idx_begin;
         bool send_or_receive;    // true means send and false means receive
@@ -82,11 +83,24 @@ class Runtime_trans_algorithm
         int bypass_counter;
         bool timer_not_bypassed;
         int comm_tag;
+        bool pipelined_transfer;
+        int *fields_transfer_size_with_remote_procs;
+        int *fields_transfer_displs_with_remote_procs;
+        bool *fields_received;
+        bool fields_segments_posted;
+        bool received_tags_checked;
+        int fields_receive_buffer_index;
 
         bool send(bool);
         bool recv(bool);
         long get_receive_data_time();
         bool is_remote_data_buf_ready(bool);
+        bool is_receive_postponed();
+        bool check_received_tags();
+        int get_empty_history_receive_buffer();
+        void fill_send_tags(int, bool, long);
+        void send_fields_segments(bool, long);
+        void copy_received_field(int);
         bool set_local_tags();
         void preprocess();
         void pack_MD_data(int, int, int *);
@@ -112,6 +126,33 @@ class Runtime_trans_algorithm
         void receive_data_in_temp_buffer();
 	void set_for_halo_exchange() { for_halo_exchange = true; }
         long get_history_receive_sender_time();
+        bool is_pipelined_transfer() { return pipelined_transfer; }
+        void start_receiving_fields(bool);
+        void receive_field(int);
+        void finish_receiving_fields(bool);
+};
+
+
+class Runtime_halo_exchange_algorithm
+{
+    private:
+        Runtime_trans_algorithm *send_algorithm;
+        Runtime_trans_algorithm *recv_algorithm;
+        MPI_Comm neighbor_comm;
+        MPI_Request request;
+        std::vector<int> send_procs_index;
+        std::vector<int> recv_procs_index;
+        int *send_counts;
+        int *send_displs;
+        int *recv_counts;
+        int *recv_displs;
+        bool exchange_in_progress;
+
+    public:
+        Runtime_halo_exchange_algorithm(Runtime_trans_algorithm *, Runtime_trans_algorithm *);
+        ~Runtime_halo_exchange_algorithm();
+        void start_exchange();
+        void finish_exchange();
 };
 
 
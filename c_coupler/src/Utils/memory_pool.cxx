@@ -0,0 +1,114 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#include "global_data.h"
+#include "memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+
+#define BUFFER_POOL_TOUCH_PAGE_SIZE      ((long)4096)
+
+
+Aligned_buffer_pool::Aligned_buffer_pool(bool huge_page_enabled)
+{
+    this->huge_page_enabled = huge_page_enabled;
+    total_allocated_size = 0;
+}
+
+
+Aligned_buffer_pool::~Aligned_buffer_pool()
+{
+    for (std::map<void*, long>::iterator iter = allocated_buffers.begin(); iter != allocated_buffers.end(); iter ++)
+        free(iter->first);
+    for (std::multimap<long, void*>::iterator iter = free_buffers.begin(); iter != free_buffers.end(); iter ++)
+        free(iter->second);
+}
+
+
+/* Sizes are rounded up to size classes (multiples of the alignment for small blocks, and eighths of the enclosing
+   power of two for large blocks), so that buffers released by short-lived temporaries can be reused by later ones. 
+   Blocks backed by huge pages are further rounded up to whole huge pages */
+long Aligned_buffer_pool::get_block_size(long size)
+{
+    long power_of_two = 1, block_size;
+
+
+    if (size <= 64*BUFFER_POOL_ALIGNMENT)
+        return ((size+BUFFER_POOL_ALIGNMENT-1)/BUFFER_POOL_ALIGNMENT)*BUFFER_POOL_ALIGNMENT;
+
+    while (power_of_two*2 <= size)
+        power_of_two *= 2;
+    block_size = ((size+power_of_two/8-1)/(power_of_two/8))*(power_of_two/8);
+    if (huge_page_enabled && block_size >= BUFFER_POOL_HUGE_PAGE_SIZE)
+        block_size = ((block_size+BUFFER_POOL_HUGE_PAGE_SIZE-1)/BUFFER_POOL_HUGE_PAGE_SIZE)*BUFFER_POOL_HUGE_PAGE_SIZE;
+
+    return block_size;
+}
+
+
+/* The pages of a buffer are first touched with the same static schedule as the loops that later process the data,
+   so that they are placed on the NUMA node of the threads (or the process) that use them */
+void Aligned_buffer_pool::first_touch(char *buf, long size)
+{
+    long num_pages = (size+BUFFER_POOL_TOUCH_PAGE_SIZE-1) / BUFFER_POOL_TOUCH_PAGE_SIZE;
+
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long i = 0; i < num_pages; i ++)
+        memset(buf+i*BUFFER_POOL_TOUCH_PAGE_SIZE, 0, (i == num_pages-1)? size-i*BUFFER_POOL_TOUCH_PAGE_SIZE : BUFFER_POOL_TOUCH_PAGE_SIZE);
+}
+
+
+void *Aligned_buffer_pool::allocate(long size)
+{
+    long block_size = get_block_size(size > 0? size : 1), alignment = BUFFER_POOL_ALIGNMENT;
+    std::multimap<long, void*>::iterator iter;
+    void *buf = NULL;
+
+
+    iter = free_buffers.find(block_size);
+    if (iter != free_buffers.end()) {
+        buf = iter->second;
+        free_buffers.erase(iter);
+    }
+    else {
+        if (huge_page_enabled && block_size >= BUFFER_POOL_HUGE_PAGE_SIZE)
+            alignment = BUFFER_POOL_HUGE_PAGE_SIZE;
+        EXECUTION_REPORT(REPORT_ERROR, -1, posix_memalign(&buf, alignment, block_size) == 0 && buf != NULL, "Fail to allocate an aligned buffer of %ld bytes for field data: the memory may be not enough", block_size);
+#ifdef MADV_HUGEPAGE
+        if (alignment == BUFFER_POOL_HUGE_PAGE_SIZE)
+            madvise(buf, block_size, MADV_HUGEPAGE);
+#endif
+        total_allocated_size += block_size;
+    }
+    first_touch((char*) buf, block_size);
+    allocated_buffers[buf] = block_size;
+
+    return buf;
+}
+
+
+/* Returns false when the buffer is not allocated by the pool, so that the caller should release it by itself */
+bool Aligned_buffer_pool::release(void *buf)
+{
+    std::map<void*, long>::iterator iter = allocated_buffers.find(buf);
+
+
+    if (iter == allocated_buffers.end())
+        return false;
+
+    free_buffers.insert(std::pair<long, void*>(iter->second, buf));
+    allocated_buffers.erase(iter);
+
+    return true;
+}
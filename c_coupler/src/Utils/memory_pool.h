@@ -0,0 +1,40 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+
+#include <map>
+
+
+#define BUFFER_POOL_ALIGNMENT            ((long)64)
+#define BUFFER_POOL_HUGE_PAGE_SIZE       ((long)2*1024*1024)
+
+
+class Aligned_buffer_pool
+{
+    private:
+        bool huge_page_enabled;
+        std::map<void*, long> allocated_buffers;
+        std::multimap<long, void*> free_buffers;
+        long total_allocated_size;
+
+        long get_block_size(long);
+        void first_touch(char *, long);
+
+    public:
+        Aligned_buffer_pool(bool);
+        ~Aligned_buffer_pool();
+        void *allocate(long);
+        bool release(void *);
+};
+
+
+#endif
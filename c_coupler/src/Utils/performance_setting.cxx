@@ -0,0 +1,72 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#include "global_data.h"
+#include "performance_setting.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+int history_output_aggregators;
+int pipelined_field_transfer;
+int neighbor_halo_exchange;
+int pooled_field_buffers;
+int huge_page_field_buffers;
+int remap_composition_fill_in_ratio;
+int parallel_restart_read;
+int lazy_restart_read;
+int incremental_restart_interval;
+
+
+static int import_integer_setting(TiXmlElement *XML_element, const char *keyword, int default_value, int min_value, const char *XML_file_name)
+{
+    int line_number;
+
+
+    const char *setting = XML_element->Attribute(keyword, &line_number);
+    if (setting == NULL)
+        return default_value;
+    EXECUTION_REPORT(REPORT_ERROR, -1, is_string_decimal_number(setting) && atoi(setting) >= min_value, "Error happens when loading the XML file \"%s\": the value of \"%s\" must be an integer that is not smaller than %d. Please verify the XML file around line number %d", XML_file_name, keyword, min_value, line_number);
+    return atoi(setting);
+}
+
+
+void import_performance_setting()
+{
+    char XML_file_name[NAME_STR_SIZE];
+
+
+    history_output_aggregators = 0;
+    pipelined_field_transfer = 0;
+    neighbor_halo_exchange = 0;
+    pooled_field_buffers = 0;
+    huge_page_field_buffers = 0;
+    remap_composition_fill_in_ratio = 0;
+    parallel_restart_read = 0;
+    lazy_restart_read = 0;
+    incremental_restart_interval = 0;
+
+    sprintf(XML_file_name, "%s/all/CCPL_performance.xml", comp_comm_group_mgt_mgr->get_config_root_dir());
+    TiXmlDocument *XML_file = open_XML_file_to_read(-1, XML_file_name, MPI_COMM_WORLD, false);
+    if (XML_file == NULL)
+        return;
+
+    TiXmlElement *XML_element = XML_file->FirstChildElement();
+    history_output_aggregators = import_integer_setting(XML_element, "history_output_aggregators", 0, 0, XML_file_name);
+    pipelined_field_transfer = import_integer_setting(XML_element, "pipelined_field_transfer", 0, 0, XML_file_name);
+    neighbor_halo_exchange = import_integer_setting(XML_element, "neighbor_halo_exchange", 0, 0, XML_file_name);
+    pooled_field_buffers = import_integer_setting(XML_element, "pooled_field_buffers", 0, 0, XML_file_name);
+    huge_page_field_buffers = import_integer_setting(XML_element, "huge_page_field_buffers", 0, 0, XML_file_name);
+    remap_composition_fill_in_ratio = import_integer_setting(XML_element, "remap_composition_fill_in_ratio", 0, 0, XML_file_name);
+    parallel_restart_read = import_integer_setting(XML_element, "parallel_restart_read", 0, 0, XML_file_name);
+    lazy_restart_read = import_integer_setting(XML_element, "lazy_restart_read", 0, 0, XML_file_name);
+    incremental_restart_interval = import_integer_setting(XML_element, "incremental_restart_interval", 0, 0, XML_file_name);
+
+    delete XML_file;
+}
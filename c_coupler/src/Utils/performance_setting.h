@@ -0,0 +1,28 @@
+/***************************************************************
+  *  Copyright (c) 2017, Tsinghua University.
+  *  This is a source file of C-Coupler.
+  *  This file was initially finished by Dr. Li Liu. 
+  *  If you have any problem, 
+  *  please contact Dr. Li Liu via liuli-cess@tsinghua.edu.cn
+  ***************************************************************/
+
+
+#ifndef PERFORMANCE_SETTING_H
+#define PERFORMANCE_SETTING_H
+
+
+extern int history_output_aggregators;
+extern int pipelined_field_transfer;
+extern int neighbor_halo_exchange;
+extern int pooled_field_buffers;
+extern int huge_page_field_buffers;
+extern int remap_composition_fill_in_ratio;
+extern int parallel_restart_read;
+extern int lazy_restart_read;
+extern int incremental_restart_interval;
+
+
+extern void import_performance_setting();
+
+
+#endif